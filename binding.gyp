@@ -7,21 +7,35 @@
       "cflags_cc!": [ "-fno-exceptions", "-fno-rtti" ],
       "link_settings": {
           "libraries": [
-              "$(HOME)/.wasmedge/lib/libwasmedge-tensorflow_c.so",
-              "$(HOME)/.wasmedge/lib/libwasmedge-tensorflowlite_c.so",
-              "$(HOME)/.wasmedge/lib/libwasmedge-image_c.so",
               "$(HOME)/.wasmedge/lib/libwasmedge_c.so",
-              "$(HOME)/.wasmedge/lib/libtensorflow.so",
-              "$(HOME)/.wasmedge/lib/libtensorflow_framework.so",
-              "$(HOME)/.wasmedge/lib/libtensorflowlite_c.so",
+              "-ldl",
+              "-lrt",
           ]
       },
       "sources": [
         "src/wasmedgeaddon.cc",
         "src/addon.cc",
+        "src/asyncrun.cc",
         "src/bytecode.cc",
+        "src/cachebundle.cc",
+        "src/compiler.cc",
+        "src/compileworker.cc",
+        "src/extensions.cc",
+        "src/filearg.cc",
+        "src/hostimports.cc",
+        "src/memfs.cc",
+        "src/memoize.cc",
+        "src/modulestream.cc",
+        "src/msgpack.cc",
         "src/options.cc",
+        "src/perfcounters.cc",
+        "src/profiler.cc",
+        "src/registry.cc",
+        "src/sha256.cc",
         "src/utils.cc",
+        "src/validation.cc",
+        "src/values.cc",
+        "src/wasminfo.cc",
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -30,13 +44,38 @@
       ],
       'defines': [ 'NAPI_DISABLE_CPP_EXCEPTIONS' ],
     },
+    {
+      "target_name": "wasmedge-precompile",
+      "type": "executable",
+      "cflags_cc": [ "-std=c++17" ],
+      "cflags!": [ "-fno-exceptions", "-fno-rtti" ],
+      "cflags_cc!": [ "-fno-exceptions", "-fno-rtti" ],
+      "link_settings": {
+          "libraries": [
+              "$(HOME)/.wasmedge/lib/libwasmedge_c.so",
+          ]
+      },
+      "sources": [
+        "utils/precompile/precompile.cc",
+        "src/bytecode.cc",
+        "src/compiler.cc",
+        "src/sha256.cc",
+      ],
+      "include_dirs": [
+        "src",
+        "$(HOME)/.wasmedge/include",
+      ],
+    },
     {
       "target_name": "action_after_build",
       "type": "none",
-      "dependencies": [ "<(module_name)" ],
+      "dependencies": [ "<(module_name)", "wasmedge-precompile" ],
       "copies": [
         {
-          "files": [ "<(PRODUCT_DIR)/<(module_name).node" ],
+          "files": [
+            "<(PRODUCT_DIR)/<(module_name).node",
+            "<(PRODUCT_DIR)/wasmedge-precompile",
+          ],
           "destination": "<(module_path)"
         }
       ]
@@ -4,5 +4,17 @@ var binding_path =
     binary.find(path.resolve(path.join(__dirname, './package.json')));
 
 const os = require('os');
-process.dlopen(module, binding_path,
-               os.constants.dlopen.RTLD_LAZY | os.constants.dlopen.RTLD_GLOBAL);
+process.dlopen(module, binding_path, os.constants.dlopen.RTLD_LAZY);
+
+// Create a VM from a readable stream of bytecode, e.g. an HTTP response or
+// an object storage download. Chunks are hashed and copied into native memory
+// as they arrive; when the stream ends the module is looked up in the AoT
+// cache and parsed on the thread pool.
+module.exports.VM.fromStream = async function(readable, options) {
+  const stream = new module.exports.ModuleStream(options || {});
+  for await (const chunk of readable) {
+    stream.write(chunk);
+  }
+  await stream.end();
+  return new module.exports.VM(stream, options);
+};
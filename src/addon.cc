@@ -1,9 +1,23 @@
+#include "cachebundle.h"
+#include "compileworker.h"
+#include "modulestream.h"
 #include "wasmedgeaddon.h"
 
 #include <napi.h>
 
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
-  return WasmEdgeAddon::Init(env, exports);
+  exports = WasmEdgeAddon::Init(env, exports);
+  Napi::Function Stream = WASMEDGE::NAPI::ModuleStream::Init(env);
+  env.GetInstanceData<AddonData>()->StreamConstructor =
+      Napi::Persistent(Stream);
+  exports.Set("ModuleStream", Stream);
+  exports.Set("compileAll",
+              Napi::Function::New(env, WASMEDGE::NAPI::CompileAll));
+  Napi::Object Cache = Napi::Object::New(env);
+  Cache.Set("export", Napi::Function::New(env, WASMEDGE::NAPI::ExportCache));
+  Cache.Set("import", Napi::Function::New(env, WASMEDGE::NAPI::ImportCache));
+  exports.Set("cache", Cache);
+  return exports;
 }
 
 NODE_API_MODULE(addon, InitAll)
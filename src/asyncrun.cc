@@ -0,0 +1,126 @@
+#include "asyncrun.h"
+#include "errors.h"
+#include "values.h"
+
+namespace WASMEDGE {
+namespace NAPI {
+
+Napi::Error makeCodedError(Napi::Env Env, ErrorType Type, const char *Code) {
+  Napi::Error Err = Napi::Error::New(Env, ErrorMsgs.at(Type));
+  Err.Set("code", Napi::String::New(Env, Code));
+  return Err;
+}
+
+Napi::Error makeAbortError(Napi::Env Env) {
+  Napi::Error Err =
+      makeCodedError(Env, ErrorType::ExecutionAborted, "ABORT_ERR");
+  Err.Set("name", Napi::String::New(Env, "AbortError"));
+  return Err;
+}
+
+void PendingCall::watchSignal(Napi::Env Env, std::function<void()> &&OnAbort) {
+  if (Signal.IsEmpty()) {
+    return;
+  }
+  Napi::Object Target = Signal.Value();
+  Napi::Value Add = Target.Get("addEventListener");
+  if (!Add.IsFunction()) {
+    return;
+  }
+  Napi::Function Listener = Napi::Function::New(
+      Env, [OnAbort = std::move(OnAbort)](const Napi::CallbackInfo &) {
+        OnAbort();
+      });
+  Add.As<Napi::Function>().Call(Target,
+                                {Napi::String::New(Env, "abort"), Listener});
+  AbortListener = Napi::Persistent(Listener);
+}
+
+void PendingCall::unwatchSignal() {
+  if (AbortListener.IsEmpty()) {
+    return;
+  }
+  Napi::Object Target = Signal.Value();
+  Napi::Value Remove = Target.Get("removeEventListener");
+  if (Remove.IsFunction()) {
+    Remove.As<Napi::Function>().Call(
+        Target,
+        {Napi::String::New(Target.Env(), "abort"), AbortListener.Value()});
+  }
+  AbortListener.Reset();
+}
+
+AsyncRunWorker::AsyncRunWorker(Napi::Env Env, const Napi::Object &Self,
+                               Napi::Promise::Deferred Deferred,
+                               std::shared_ptr<AsyncExecution> Execution,
+                               std::vector<WasmEdge_ValType> &&RetTypes,
+                               std::function<void()> &&OnDone)
+    : Napi::AsyncWorker(Env), Deferred(Deferred),
+      Self(Napi::Persistent(Self)), Execution(std::move(Execution)),
+      RetTypes(std::move(RetTypes)), Rets(this->RetTypes.size()),
+      OnDone(std::move(OnDone)) {}
+
+bool AsyncRunWorker::connectSignal(const Napi::Object &Signal) {
+  if (Signal.Get("aborted").ToBoolean().Value()) {
+    return false;
+  }
+  std::shared_ptr<AsyncExecution> Target = Execution;
+  Napi::Function Abort = Napi::Function::New(
+      Env(), [Target](const Napi::CallbackInfo &) { Target->cancel(); });
+  Napi::Value Add = Signal.Get("addEventListener");
+  if (Add.IsFunction()) {
+    Add.As<Napi::Function>().Call(
+        Signal, {Napi::String::New(Env(), "abort"), Abort});
+    this->Signal = Napi::Persistent(Signal);
+    Listener = Napi::Persistent(Abort);
+  }
+  return true;
+}
+
+void AsyncRunWorker::disconnectSignal() {
+  if (Signal.IsEmpty()) {
+    return;
+  }
+  Napi::Object Target = Signal.Value();
+  Napi::Value Remove = Target.Get("removeEventListener");
+  if (Remove.IsFunction()) {
+    Remove.As<Napi::Function>().Call(
+        Target, {Napi::String::New(Env(), "abort"), Listener.Value()});
+  }
+  Signal.Reset();
+  Listener.Reset();
+}
+
+void AsyncRunWorker::Execute() { Res = Execution->wait(Rets); }
+
+void AsyncRunWorker::OnOK() {
+  Napi::Env Env = this->Env();
+  Napi::HandleScope Scope(Env);
+  disconnectSignal();
+  OnDone();
+  if (Execution->isCancelled()) {
+    Deferred.Reject(makeAbortError(Env).Value());
+    return;
+  }
+  if (!WasmEdge_ResultOK(Res)) {
+    Deferred.Reject(
+        Napi::Error::New(Env, ErrorMsgs.at(ErrorType::ExecutionFailed))
+            .Value());
+    return;
+  }
+  Napi::Array Results = Napi::Array::New(Env, Rets.size());
+  for (uint32_t I = 0; I < Rets.size(); I++) {
+    Results.Set(I, toNapiValue(Env, Rets[I]));
+  }
+  Deferred.Resolve(Results);
+}
+
+void AsyncRunWorker::OnError(const Napi::Error &Err) {
+  Napi::HandleScope Scope(Env());
+  disconnectSignal();
+  OnDone();
+  Deferred.Reject(Err.Value());
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
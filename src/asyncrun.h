@@ -0,0 +1,128 @@
+#pragma once
+
+#include "errors.h"
+#include "scheduler.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <vector>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// An execution started with WasmEdge_VMAsyncExecute. It can be cancelled
+/// from the JS thread while a worker thread waits for it.
+class AsyncExecution {
+public:
+  explicit AsyncExecution(WasmEdge_Async *Async) : Async(Async) {}
+  ~AsyncExecution() { WasmEdge_AsyncDelete(Async); }
+  AsyncExecution(const AsyncExecution &) = delete;
+  AsyncExecution &operator=(const AsyncExecution &) = delete;
+
+  /// Interrupt the guest. The interpreter stops at the next instruction;
+  /// AOT code only if it was compiled with CompilerInterruptible.
+  void cancel() {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!Cancelled && !Finished) {
+      Cancelled = true;
+      WasmEdge_AsyncCancel(Async);
+    }
+  }
+  bool isCancelled() {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Cancelled;
+  }
+  /// Block until the guest returns or is interrupted.
+  WasmEdge_Result wait(std::vector<WasmEdge_Value> &Rets) {
+    WasmEdge_AsyncWait(Async);
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      Finished = true;
+    }
+    return WasmEdge_AsyncGet(Async, Rets.data(), Rets.size());
+  }
+
+private:
+  std::mutex Mutex;
+  WasmEdge_Async *Async;
+  bool Cancelled = false;
+  bool Finished = false;
+};
+
+/// Create an error with a `code` property, for promises rejected by the
+/// asynchronous execution layer.
+Napi::Error makeCodedError(Napi::Env Env, ErrorType Type, const char *Code);
+
+/// Create the error a promise is rejected with when its call was aborted.
+/// Like the errors of Node's own AbortSignal aware APIs, its name is
+/// `AbortError` and its code is `ABORT_ERR`.
+Napi::Error makeAbortError(Napi::Env Env);
+
+/// A RunAsync call waiting in the admission queue.
+struct PendingCall {
+  explicit PendingCall(Napi::Env Env)
+      : Deferred(Napi::Promise::Deferred::New(Env)) {}
+
+  Napi::Promise::Deferred Deferred;
+  std::string FuncName;
+  std::vector<Napi::Reference<Napi::Value>> Values;
+  Napi::ObjectReference Signal;
+  Priority Class = Priority::Normal;
+  std::chrono::steady_clock::time_point Deadline =
+      std::chrono::steady_clock::time_point::max();
+
+  bool isAborted() const {
+    return !Signal.IsEmpty() &&
+           Signal.Value().Get("aborted").ToBoolean().Value();
+  }
+  /// Call `OnAbort` when the signal fires while the call is queued.
+  void watchSignal(Napi::Env Env, std::function<void()> &&OnAbort);
+  /// Remove the listener of watchSignal(). Must be called when the call
+  /// leaves the queue, as `OnAbort` may refer to the queue.
+  void unwatchSignal();
+
+private:
+  Napi::FunctionReference AbortListener;
+};
+
+/// Wait for an AsyncExecution on the libuv thread pool and settle a promise.
+///
+/// An `AbortSignal` given in the options is connected to
+/// AsyncExecution::cancel() while the call is running. `OnDone` is called on
+/// the JS thread before the promise is settled, to release the VM.
+class AsyncRunWorker : public Napi::AsyncWorker {
+public:
+  AsyncRunWorker(Napi::Env Env, const Napi::Object &Self,
+                 Napi::Promise::Deferred Deferred,
+                 std::shared_ptr<AsyncExecution> Execution,
+                 std::vector<WasmEdge_ValType> &&RetTypes,
+                 std::function<void()> &&OnDone);
+
+  /// Abort the call when `Signal` fires. Returns false if it already has.
+  bool connectSignal(const Napi::Object &Signal);
+
+protected:
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &Err) override;
+
+private:
+  void disconnectSignal();
+
+  Napi::Promise::Deferred Deferred;
+  Napi::ObjectReference Self;
+  Napi::ObjectReference Signal;
+  Napi::FunctionReference Listener;
+  std::shared_ptr<AsyncExecution> Execution;
+  std::vector<WasmEdge_ValType> RetTypes;
+  std::vector<WasmEdge_Value> Rets;
+  WasmEdge_Result Res;
+  std::function<void()> OnDone;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
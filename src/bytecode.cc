@@ -1,6 +1,11 @@
 #include "bytecode.h"
 
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <boost/functional/hash.hpp>
 #include <iterator>
@@ -15,7 +20,18 @@ void Bytecode::setPath(const std::string &IPath) noexcept {
 
 void Bytecode::setData(const std::vector<uint8_t> &IData) noexcept {
   Data = IData;
-  if (isWasm()) {
+  detectMode();
+}
+
+void Bytecode::setData(std::vector<uint8_t> &&IData) noexcept {
+  Data = std::move(IData);
+  detectMode();
+}
+
+void Bytecode::detectMode() noexcept {
+  if (Data.size() < 4) {
+    Mode = InputMode::Invalid;
+  } else if (isWasm()) {
     Mode = InputMode::WasmBytecode;
   } else if (isELF()) {
     Mode = InputMode::ELFBytecode;
@@ -45,10 +61,31 @@ void Bytecode::setFileMode() noexcept {
   size_t CodeHash = boost::hash_range(Data.begin(), Data.end());
   Path = std::string("/tmp/wasmedge.tmp.") + std::to_string(CodeHash) +
          std::string(".wasm");
-  std::ofstream File(Path.c_str());
-  std::ostream_iterator<uint8_t> OutIter(File);
-  std::copy(Data.begin(), Data.end(), OutIter);
-  File.close();
+  /// Other VMs may be compiling from `Path` right now. Write a new file and
+  /// rename it into place instead of truncating the shared one; mkstemp also
+  /// refuses a name planted in /tmp.
+  std::string TmpPath = Path + ".XXXXXX";
+  int FD = mkstemp(TmpPath.data());
+  if (FD >= 0) {
+    const uint8_t *Next = Data.data();
+    size_t Left = Data.size();
+    bool Written = fchmod(FD, 0644) == 0;
+    while (Written && Left > 0) {
+      const ssize_t Res = write(FD, Next, Left);
+      if (Res < 0 && errno == EINTR) {
+        continue;
+      }
+      Written = Res > 0;
+      if (Written) {
+        Next += Res;
+        Left -= Res;
+      }
+    }
+    Written = close(FD) == 0 && Written;
+    if (!Written || std::rename(TmpPath.c_str(), Path.c_str()) != 0) {
+      std::remove(TmpPath.c_str());
+    }
+  }
   Mode = InputMode::FilePath;
 }
 
@@ -95,7 +132,7 @@ bool Bytecode::isCompiled() const noexcept {
 }
 
 bool Bytecode::isValidData() const noexcept {
-  if (isFile()) {
+  if (isFile() || Data.size() < 4) {
     return false;
   }
   if (isWasm() || isELF() || isMachO()) {
@@ -26,7 +26,11 @@ public:
   void setPath(const std::string &IPath) noexcept;
   const std::string &getPath() const noexcept { return Path; }
   void setData(const std::vector<uint8_t> &IData) noexcept;
+  void setData(std::vector<uint8_t> &&IData) noexcept;
   const std::vector<uint8_t> &getData() noexcept;
+  /// Size of the bytecode held in memory. Does not read the file in FilePath
+  /// mode.
+  size_t getDataSize() const noexcept { return Data.size(); }
   void setFileMode() noexcept;
   bool isFile() const noexcept;
   bool isWasm() const noexcept;
@@ -34,6 +38,9 @@ public:
   bool isMachO() const noexcept;
   bool isCompiled() const noexcept;
   bool isValidData() const noexcept;
+
+private:
+  void detectMode() noexcept;
 };
 
 } // namespace NAPI
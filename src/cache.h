@@ -1,28 +1,50 @@
 #pragma once
 
+#include "compiler.h"
+#include "sha256.h"
+
 #include <fstream> // std::ifstream, std::ofstream
 #include <iterator>
 #include <limits>
 #include <string>
-
-#include <boost/functional/hash.hpp>
+#include <vector>
 
 namespace WASMEDGE {
 namespace NAPI {
 
 class Cache {
+public:
+  /// How entry names are derived from the bytecode and the settings. Cache
+  /// bundles record it, change it whenever init() changes.
+  static constexpr const char *kKeyScheme = "sha256-1";
+
 private:
   std::string Path;
-  size_t CodeHash;
+  Sha256::Digest CodeHash;
 
 public:
-  inline void init(const std::vector<uint8_t> &Data) {
-    Path = std::string("/tmp/wasmedge.tmp.") + std::to_string(hash(Data)) +
-           std::string(".so");
+  /// The cache key covers the bytecode and the compiler settings.
+  inline void init(const std::vector<uint8_t> &Data,
+                   const CompilerOptions &Opts = CompilerOptions()) {
+    init(hash(Data), Opts);
+  }
+
+  /// For bytecode which was hashed as it arrived. The key is a SHA-256, so
+  /// it does not depend on how the bytecode was split into chunks and stays
+  /// the same across builds, which `cache.export()` bundles rely on.
+  inline void init(const Sha256::Digest &Hash, const CompilerOptions &Opts) {
+    CodeHash = Hash;
+    const std::string Settings = Opts.key();
+    Sha256 Key;
+    Key.update(Hash.data(), Hash.size());
+    Key.update(reinterpret_cast<const uint8_t *>(Settings.data()),
+               Settings.size());
+    Path = std::string("/tmp/wasmedge.tmp.") + Sha256::toHex(Key.finish()) +
+           std::string(Opts.extension());
   }
 
-  inline size_t hash(const std::vector<uint8_t> &Data) {
-    CodeHash = boost::hash_range(Data.begin(), Data.end());
+  inline Sha256::Digest hash(const std::vector<uint8_t> &Data) {
+    CodeHash = Sha256::hash(Data.data(), Data.size());
     return CodeHash;
   }
 
@@ -0,0 +1,417 @@
+#include "cachebundle.h"
+#include "cache.h"
+#include "errors.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <vector>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+const char *kBundleMagic = "WASMEDGE-AOT-BUNDLE 1";
+const char *kCacheDir = "/tmp";
+const char *kCachePrefix = "wasmedge.tmp.";
+
+struct BundleEntry {
+  std::string Name;
+  uint64_t Offset;
+  uint64_t Size;
+  uint64_t Checksum;
+};
+
+/// FNV-1a, which can be computed over the artifact in chunks.
+uint64_t fnv1a(uint64_t Hash, const char *Data, size_t Size) {
+  for (size_t I = 0; I < Size; I++) {
+    Hash ^= static_cast<uint8_t>(Data[I]);
+    Hash *= 1099511628211ULL;
+  }
+  return Hash;
+}
+const uint64_t kFnvOffset = 14695981039346656037ULL;
+
+/// `wasmedge.tmp.<sha256 hex>.so` or `.wasm`; also guards against paths in a
+/// crafted index.
+bool isCacheEntryName(const std::string &Name) {
+  const size_t PrefixLen = strlen(kCachePrefix);
+  const size_t Dot = Name.rfind('.');
+  if (Name.compare(0, PrefixLen, kCachePrefix) != 0 || Dot < PrefixLen) {
+    return false;
+  }
+  const std::string Extension = Name.substr(Dot);
+  const std::string Key = Name.substr(PrefixLen, Dot - PrefixLen);
+  return (Extension == ".so" || Extension == ".wasm") && Key.size() == 64 &&
+         std::all_of(Key.begin(), Key.end(), [](char C) {
+           return (C >= '0' && C <= '9') || (C >= 'a' && C <= 'f');
+         });
+}
+
+std::string machineArch() {
+  struct utsname Name;
+  return uname(&Name) == 0 ? Name.machine : "unknown";
+}
+
+/// Whether a /proc/cpuinfo flag is an instruction set extension the compiler
+/// may use. Other flags (e.g. `hypervisor`) differ between otherwise
+/// compatible hosts.
+bool isISAFeature(const std::string &Flag) {
+  static const char *Prefixes[] = {
+      "sse",   "ssse3", "avx",  "fma",       "f16c",       "bmi",
+      "popcnt", "abm",  "lzcnt", "movbe",    "aes",        "pclmulqdq",
+      "sha",   "adx",   "gfni", "vaes",      "vpclmulqdq", "rdrnd",
+      "rdseed", "xsave", "asimd", "fp",      "crc32",      "atomics",
+      "sve",   "sm3",   "sm4",  "dotprod"};
+  for (const char *Prefix : Prefixes) {
+    if (Flag.compare(0, strlen(Prefix), Prefix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// The instruction set extensions of the host from /proc/cpuinfo (`flags`
+/// on x86, `Features` on Arm).
+std::set<std::string> cpuFeatures() {
+  std::set<std::string> Features;
+  std::ifstream CPUInfo("/proc/cpuinfo");
+  std::string Line;
+  while (std::getline(CPUInfo, Line)) {
+    if (Line.compare(0, 5, "flags") == 0 ||
+        Line.compare(0, 8, "Features") == 0) {
+      std::istringstream Flags(Line.substr(Line.find(':') + 1));
+      std::string Flag;
+      while (Flags >> Flag) {
+        if (isISAFeature(Flag)) {
+          Features.insert(Flag);
+        }
+      }
+      break;
+    }
+  }
+  return Features;
+}
+
+/// Copy `Size` bytes from `In` to `Write` and compute their checksum.
+template <typename WriteT>
+bool copyBytes(std::istream &In, uint64_t Size, uint64_t &Checksum,
+               WriteT &&Write) {
+  std::vector<char> Buffer(1 << 20);
+  Checksum = kFnvOffset;
+  while (Size > 0) {
+    const size_t Chunk = static_cast<size_t>(
+        std::min<uint64_t>(Size, Buffer.size()));
+    if (!In.read(Buffer.data(), Chunk)) {
+      return false;
+    }
+    Checksum = fnv1a(Checksum, Buffer.data(), Chunk);
+    if (!Write(Buffer.data(), Chunk)) {
+      return false;
+    }
+    Size -= Chunk;
+  }
+  return true;
+}
+
+bool copyBytes(std::istream &In, std::ostream &Out, uint64_t Size,
+               uint64_t &Checksum) {
+  return copyBytes(In, Size, Checksum,
+                   [&Out](const char *Data, size_t Len) {
+                     return static_cast<bool>(Out.write(Data, Len));
+                   }) &&
+         Out.good();
+}
+
+bool writeAll(int FD, const char *Data, size_t Size) {
+  while (Size > 0) {
+    const ssize_t Written = write(FD, Data, Size);
+    if (Written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (Written < 0) {
+      return false;
+    }
+    Data += Written;
+    Size -= Written;
+  }
+  return true;
+}
+
+std::string indexChecksum(const std::string &Index) {
+  return std::to_string(fnv1a(kFnvOffset, Index.data(), Index.size()));
+}
+
+} // namespace
+
+bool exportCacheBundle(const std::string &Path, CacheBundleStats &Stats,
+                       std::string &Error) {
+  std::vector<BundleEntry> Entries;
+  std::error_code EC;
+  for (const auto &Entry : std::filesystem::directory_iterator(kCacheDir, EC)) {
+    const std::string Name = Entry.path().filename().string();
+    if (!isCacheEntryName(Name) ||
+        !std::filesystem::is_regular_file(Entry.symlink_status())) {
+      continue;
+    }
+    Entries.push_back({Name, 0, std::filesystem::file_size(Entry.path(), EC),
+                       0});
+  }
+  std::sort(Entries.begin(), Entries.end(),
+            [](const BundleEntry &A, const BundleEntry &B) {
+              return A.Name < B.Name;
+            });
+
+  /// Write the artifacts first, the index needs their checksums.
+  const std::string DataPath = Path + ".data." + std::to_string(getpid());
+  {
+    std::ofstream Data(DataPath, std::ios::binary | std::ios::trunc);
+    uint64_t Offset = 0;
+    for (auto &Entry : Entries) {
+      std::ifstream In(std::string(kCacheDir) + "/" + Entry.Name,
+                       std::ios::binary);
+      Entry.Offset = Offset;
+      if (!copyBytes(In, Data, Entry.Size, Entry.Checksum)) {
+        Error = "Failed to pack " + Entry.Name;
+        Data.close();
+        std::remove(DataPath.c_str());
+        return false;
+      }
+      Offset += Entry.Size;
+    }
+    Stats.Bytes = Offset;
+  }
+
+  std::ostringstream Index;
+  Index << "version " << WasmEdge_VersionGet() << '\n';
+  Index << "key " << Cache::kKeyScheme << '\n';
+  Index << "arch " << machineArch() << '\n';
+  Index << "features";
+  for (const auto &Feature : cpuFeatures()) {
+    Index << ' ' << Feature;
+  }
+  Index << '\n';
+  for (const auto &Entry : Entries) {
+    Index << "entry " << Entry.Name << ' ' << Entry.Offset << ' '
+          << Entry.Size << ' ' << Entry.Checksum << '\n';
+  }
+  const std::string IndexText = Index.str();
+
+  {
+    std::ofstream Out(Path, std::ios::binary | std::ios::trunc);
+    std::ifstream Data(DataPath, std::ios::binary);
+    Out << kBundleMagic << '\n'
+        << IndexText << "end " << indexChecksum(IndexText) << '\n';
+    uint64_t Checksum;
+    if (!copyBytes(Data, Out, Stats.Bytes, Checksum)) {
+      Error = "Failed to write " + Path;
+      Data.close();
+      std::remove(DataPath.c_str());
+      return false;
+    }
+  }
+  std::remove(DataPath.c_str());
+  Stats.Entries = Entries.size();
+  return true;
+}
+
+bool importCacheBundle(const std::string &Path, CacheBundleStats &Stats,
+                       std::string &Error) {
+  std::ifstream In(Path, std::ios::binary);
+  std::string Line;
+  if (!std::getline(In, Line) || Line != kBundleMagic) {
+    Error = ErrorMsgs.at(ErrorType::InvalidCacheBundle);
+    return false;
+  }
+
+  std::string IndexText, Version, KeyScheme, Arch;
+  std::set<std::string> Features;
+  std::vector<BundleEntry> Entries;
+  bool Terminated = false;
+  while (std::getline(In, Line)) {
+    std::istringstream Fields(Line);
+    std::string Kind;
+    Fields >> Kind;
+    if (Kind == "end") {
+      std::string Checksum;
+      Fields >> Checksum;
+      Terminated = Checksum == indexChecksum(IndexText);
+      break;
+    }
+    IndexText += Line + '\n';
+    if (Kind == "version") {
+      Fields >> Version;
+    } else if (Kind == "key") {
+      Fields >> KeyScheme;
+    } else if (Kind == "arch") {
+      Fields >> Arch;
+    } else if (Kind == "features") {
+      std::string Feature;
+      while (Fields >> Feature) {
+        Features.insert(Feature);
+      }
+    } else if (Kind == "entry") {
+      BundleEntry Entry;
+      if (!(Fields >> Entry.Name >> Entry.Offset >> Entry.Size >>
+            Entry.Checksum) ||
+          !isCacheEntryName(Entry.Name)) {
+        break;
+      }
+      Entries.push_back(Entry);
+    }
+  }
+  if (!Terminated) {
+    Error = ErrorMsgs.at(ErrorType::InvalidCacheBundle);
+    return false;
+  }
+
+  /// Native code only runs where it was compiled for.
+  const std::string Incompatible =
+      ErrorMsgs.at(ErrorType::IncompatibleCacheBundle);
+  if (Version != WasmEdge_VersionGet()) {
+    Error = Incompatible + ": WasmEdge " + Version + ", this host has " +
+            WasmEdge_VersionGet();
+    return false;
+  }
+  /// Entry names are only found by this host if it derives them the same
+  /// way.
+  if (KeyScheme != Cache::kKeyScheme) {
+    Error = Incompatible + ": cache key scheme " +
+            (KeyScheme.empty() ? std::string("unknown") : KeyScheme) +
+            ", this host uses " + Cache::kKeyScheme;
+    return false;
+  }
+  if (Arch != machineArch()) {
+    Error = Incompatible + ": architecture " + Arch + ", this host is " +
+            machineArch();
+    return false;
+  }
+  const std::set<std::string> Local = cpuFeatures();
+  for (const auto &Feature : Features) {
+    if (Local.count(Feature) == 0) {
+      Error = Incompatible + ": this host lacks the CPU feature " + Feature;
+      return false;
+    }
+  }
+
+  const std::streampos DataStart = In.tellg();
+  for (const auto &Entry : Entries) {
+    const std::string Target = std::string(kCacheDir) + "/" + Entry.Name;
+    std::error_code EC;
+    if (std::filesystem::exists(Target, EC)) {
+      Stats.Existing++;
+      continue;
+    }
+    /// The cache directory is shared, so the temporary name must not be
+    /// guessable and must be new: mkstemp creates it with O_EXCL, which
+    /// also refuses a planted symlink.
+    std::string TmpPath = Target + ".import.XXXXXX";
+    const int FD = mkstemp(TmpPath.data());
+    if (FD < 0) {
+      Stats.Rejected++;
+      continue;
+    }
+    uint64_t Checksum = 0;
+    In.clear();
+    In.seekg(DataStart + static_cast<std::streamoff>(Entry.Offset));
+    bool Copied = fchmod(FD, 0644) == 0 &&
+                  copyBytes(In, Entry.Size, Checksum,
+                            [FD](const char *Data, size_t Len) {
+                              return writeAll(FD, Data, Len);
+                            });
+    Copied = close(FD) == 0 && Copied;
+    if (!Copied || Checksum != Entry.Checksum ||
+        std::rename(TmpPath.c_str(), Target.c_str()) != 0) {
+      std::remove(TmpPath.c_str());
+      Stats.Rejected++;
+      continue;
+    }
+    Stats.Entries++;
+    Stats.Bytes += Entry.Size;
+  }
+  return true;
+}
+
+namespace {
+
+class CacheBundleWorker : public Napi::AsyncWorker {
+public:
+  CacheBundleWorker(Napi::Env Env, std::string Path, bool Export)
+      : Napi::AsyncWorker(Env), Deferred(Napi::Promise::Deferred::New(Env)),
+        Path(std::move(Path)), Export(Export) {}
+
+  Napi::Promise getPromise() const { return Deferred.Promise(); }
+
+protected:
+  void Execute() override {
+    std::string Error;
+    const bool Succeeded = Export ? exportCacheBundle(Path, Stats, Error)
+                                  : importCacheBundle(Path, Stats, Error);
+    if (!Succeeded) {
+      SetError(Error);
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env Env = this->Env();
+    Napi::Object Result = Napi::Object::New(Env);
+    if (Export) {
+      Result.Set("entries", Napi::Number::New(Env, Stats.Entries));
+    } else {
+      Result.Set("installed", Napi::Number::New(Env, Stats.Entries));
+      Result.Set("existing", Napi::Number::New(Env, Stats.Existing));
+      Result.Set("rejected", Napi::Number::New(Env, Stats.Rejected));
+    }
+    Result.Set("bytes",
+               Napi::Number::New(Env, static_cast<double>(Stats.Bytes)));
+    Deferred.Resolve(Result);
+  }
+
+  void OnError(const Napi::Error &Err) override {
+    Deferred.Reject(Err.Value());
+  }
+
+private:
+  Napi::Promise::Deferred Deferred;
+  std::string Path;
+  bool Export;
+  CacheBundleStats Stats;
+};
+
+Napi::Value queueCacheBundle(const Napi::CallbackInfo &Info, bool Export) {
+  Napi::Env Env = Info.Env();
+  if (Info.Length() < 1 || !Info[0].IsString()) {
+    napi_throw_error(Env, "Error",
+                     ErrorMsgs.at(ErrorType::InvalidCacheBundlePath).c_str());
+    return Napi::Value();
+  }
+  auto *Worker = new CacheBundleWorker(
+      Env, Info[0].As<Napi::String>().Utf8Value(), Export);
+  Napi::Promise Promise = Worker->getPromise();
+  Worker->Queue();
+  return Promise;
+}
+
+} // namespace
+
+Napi::Value ExportCache(const Napi::CallbackInfo &Info) {
+  return queueCacheBundle(Info, true);
+}
+
+Napi::Value ImportCache(const Napi::CallbackInfo &Info) {
+  return queueCacheBundle(Info, false);
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <napi.h>
+#include <string>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Portable bundles of the AOT cache (`/tmp/wasmedge.tmp.*.so|.wasm`).
+///
+/// A bundle is one file: a text index followed by the artifacts. The index
+/// records the WasmEdge version, the scheme of the cache key, the CPU
+/// architecture and features of the exporting host, and per entry the cache
+/// file name (which encodes the SHA-256 of the bytecode and the compiler
+/// settings), its size and an FNV-1a checksum. A bundle is only installed on
+/// hosts with the same WasmEdge version, key scheme and architecture which
+/// have every CPU feature of the exporting host; artifacts compiled with
+/// `CompilerTargetCPU: "generic"` are checked the same way, as the index
+/// cannot tell them apart.
+struct CacheBundleStats {
+  uint32_t Entries = 0;
+  uint64_t Bytes = 0;
+  /// Import: entries already in the cache, and entries with a bad checksum
+  uint32_t Existing = 0;
+  uint32_t Rejected = 0;
+};
+
+/// Pack all cache entries into `Path`. Returns false and sets `Error` on
+/// failure.
+bool exportCacheBundle(const std::string &Path, CacheBundleStats &Stats,
+                       std::string &Error);
+
+/// Verify the bundle at `Path` and install its entries into the cache.
+/// Entries are written to a new temporary file (mkstemp) and renamed, so a
+/// concurrent reader never sees a partial artifact.
+bool importCacheBundle(const std::string &Path, CacheBundleStats &Stats,
+                       std::string &Error);
+
+/// JS: cache.export(path) -> Promise<{entries, bytes}>
+Napi::Value ExportCache(const Napi::CallbackInfo &Info);
+/// JS: cache.import(path) -> Promise<{installed, existing, rejected, bytes}>
+Napi::Value ImportCache(const Napi::CallbackInfo &Info);
+
+} // namespace NAPI
+} // namespace WASMEDGE
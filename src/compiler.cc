@@ -0,0 +1,174 @@
+#include "compiler.h"
+#include "utils.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <sys/file.h>
+#include <thread>
+#include <unistd.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+void CompilerOptions::apply(WasmEdge_ConfigureContext *Configure) const {
+  WasmEdge_ConfigureCompilerSetOptimizationLevel(Configure, OptLevel);
+  WasmEdge_ConfigureCompilerSetOutputFormat(Configure, OutputFormat);
+  WasmEdge_ConfigureCompilerSetGenericBinary(Configure, GenericBinary);
+  WasmEdge_ConfigureCompilerSetDumpIR(Configure, DumpIR);
+  WasmEdge_ConfigureCompilerSetInterruptible(Configure, Interruptible);
+  if (Measure) {
+    WasmEdge_ConfigureStatisticsSetCostMeasuring(Configure, true);
+    WasmEdge_ConfigureStatisticsSetInstructionCounting(Configure, true);
+  }
+}
+
+std::string CompilerOptions::key() const {
+  /// DumpIR only writes debug files and does not change the artifact.
+  return "opt=" + std::to_string(static_cast<int>(OptLevel)) +
+         " format=" + std::to_string(static_cast<int>(OutputFormat)) +
+         " generic=" + std::to_string(GenericBinary) +
+         " interruptible=" + std::to_string(Interruptible) +
+         " measure=" + std::to_string(Measure);
+}
+
+bool parseOptimizationLevel(const std::string &Str,
+                            WasmEdge_CompilerOptimizationLevel &Level) {
+  static const std::map<std::string, WasmEdge_CompilerOptimizationLevel>
+      Levels = {{"O0", WasmEdge_CompilerOptimizationLevel_O0},
+                {"O1", WasmEdge_CompilerOptimizationLevel_O1},
+                {"O2", WasmEdge_CompilerOptimizationLevel_O2},
+                {"O3", WasmEdge_CompilerOptimizationLevel_O3},
+                {"Os", WasmEdge_CompilerOptimizationLevel_Os},
+                {"Oz", WasmEdge_CompilerOptimizationLevel_Oz}};
+  auto It = Levels.find(Str);
+  if (It == Levels.end()) {
+    return false;
+  }
+  Level = It->second;
+  return true;
+}
+
+bool parseTargetCPU(const std::string &Str, bool &GenericBinary) {
+  if (Str == "native") {
+    GenericBinary = false;
+  } else if (Str == "generic") {
+    GenericBinary = true;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseOutputFormat(const std::string &Str,
+                       WasmEdge_CompilerOutputFormat &Format) {
+  if (Str == "native") {
+    Format = WasmEdge_CompilerOutputFormat_Native;
+  } else if (Str == "wasm") {
+    Format = WasmEdge_CompilerOutputFormat_Wasm;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+WasmEdge_ConfigureContext *createConfigure(const CompilerOptions &Opts) {
+  WasmEdge_ConfigureContext *Configure = WasmEdge_ConfigureCreate();
+  WasmEdge_ConfigureAddProposal(Configure,
+                                WasmEdge_Proposal_BulkMemoryOperations);
+  WasmEdge_ConfigureAddProposal(Configure, WasmEdge_Proposal_ReferenceTypes);
+  WasmEdge_ConfigureAddProposal(Configure, WasmEdge_Proposal_SIMD);
+  Opts.apply(Configure);
+  return Configure;
+}
+
+CompileResult compileFile(const WasmEdge_ConfigureContext *Configure,
+                          const std::string &InPath,
+                          const std::string &OutPath) {
+  CompileResult Result = {false, 0, "", 0.0, 0};
+
+  auto Start = std::chrono::steady_clock::now();
+  WasmEdge_CompilerContext *CompilerCxt = WasmEdge_CompilerCreate(Configure);
+  WasmEdge_Result Res =
+      WasmEdge_CompilerCompile(CompilerCxt, InPath.c_str(), OutPath.c_str());
+  WasmEdge_CompilerDelete(CompilerCxt);
+  Result.CompileTime = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - Start)
+                           .count();
+
+  if (!WasmEdge_ResultOK(Res)) {
+    Result.ErrorCode = WasmEdge_ResultGetCode(Res);
+    Result.ErrorMessage = WasmEdge_ResultGetMessage(Res);
+    return Result;
+  }
+
+  std::error_code EC;
+  Result.OutputSize = std::filesystem::file_size(OutPath, EC);
+  if (EC) {
+    Result.ErrorMessage = EC.message();
+    return Result;
+  }
+  Result.Succeeded = true;
+  return Result;
+}
+
+CacheFillStatus
+compileToCache(const WasmEdge_ConfigureContext *Configure,
+               const std::string &InPath, const std::string &CachePath,
+               bool Wait, CompileResult &Result,
+               const std::function<bool(const std::string &)> &Accept) {
+  const std::string LockPath = CachePath + ".lock";
+  int LockFD = open(LockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (LockFD >= 0) {
+    int Res;
+    do {
+      Res = flock(LockFD, Wait ? LOCK_EX : LOCK_EX | LOCK_NB);
+    } while (Res != 0 && errno == EINTR);
+    if (Res != 0 && errno == EWOULDBLOCK) {
+      close(LockFD);
+      return CacheFillStatus::Busy;
+    }
+    if (Res != 0) {
+      close(LockFD);
+      LockFD = -1;
+    }
+  }
+  /// Without a lock (e.g. a read-only lock directory) every process compiles
+  /// on its own, the rename still keeps the entry whole.
+
+  CacheFillStatus Status;
+  /// A rejected entry is not removed first, the rename below replaces it
+  /// atomically.
+  if (access(CachePath.c_str(), F_OK) == 0 && (!Accept || Accept(CachePath))) {
+    Status = CacheFillStatus::Cached;
+  } else {
+    const std::string TmpPath =
+        CachePath + ".tmp." + std::to_string(getpid()) + "." +
+        std::to_string(
+            std::hash<std::thread::id>()(std::this_thread::get_id()));
+    Result = compileFile(Configure, InPath, TmpPath);
+    if (Result.Succeeded && std::rename(TmpPath.c_str(), CachePath.c_str())) {
+      Result.Succeeded = false;
+      Result.ErrorMessage = "cannot rename the artifact into the cache";
+    }
+    if (!Result.Succeeded) {
+      std::remove(TmpPath.c_str());
+    }
+    Status =
+        Result.Succeeded ? CacheFillStatus::Compiled : CacheFillStatus::Failed;
+  }
+
+  if (LockFD >= 0) {
+    /// The lock file stays, removing it would let a late process lock a new
+    /// file while another still holds the old one.
+    flock(LockFD, LOCK_UN);
+    close(LockFD);
+  }
+  return Status;
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// AOT compiler settings. All of them change the generated code, so they are
+/// part of the cache key.
+struct CompilerOptions {
+  WasmEdge_CompilerOptimizationLevel OptLevel =
+      WasmEdge_CompilerOptimizationLevel_O3;
+  WasmEdge_CompilerOutputFormat OutputFormat =
+      WasmEdge_CompilerOutputFormat_Native;
+  bool GenericBinary = false;
+  bool DumpIR = false;
+  bool Interruptible = false;
+  bool Measure = false;
+
+  /// Apply the settings to a configure context.
+  void apply(WasmEdge_ConfigureContext *Configure) const;
+  /// The settings which affect the compiled artifact, as a stable string
+  /// for the cache key.
+  std::string key() const;
+  /// File extension of the compiled artifact.
+  const char *extension() const noexcept {
+    return OutputFormat == WasmEdge_CompilerOutputFormat_Wasm ? ".wasm"
+                                                              : ".so";
+  }
+};
+
+/// Parse "O0", "O1", "O2", "O3", "Os" or "Oz".
+bool parseOptimizationLevel(const std::string &Str,
+                            WasmEdge_CompilerOptimizationLevel &Level);
+/// Parse "native" (host CPU) or "generic".
+bool parseTargetCPU(const std::string &Str, bool &GenericBinary);
+/// Parse "native" (shared library) or "wasm" (universal wasm).
+bool parseOutputFormat(const std::string &Str,
+                       WasmEdge_CompilerOutputFormat &Format);
+
+/// Create a configure context with the proposals enabled by the addon and the
+/// given compiler settings. The caller owns the returned context.
+WasmEdge_ConfigureContext *
+createConfigure(const CompilerOptions &Opts = CompilerOptions());
+
+struct CompileResult {
+  bool Succeeded;
+  uint32_t ErrorCode;
+  std::string ErrorMessage;
+  /// Wall time spent in WasmEdge_CompilerCompile, in milliseconds.
+  double CompileTime;
+  /// Size of the output artifact in bytes.
+  uint64_t OutputSize;
+};
+
+/// AOT compile the wasm file `InPath` into `OutPath`.
+/// This function does not touch any JS state and can be used from any thread.
+CompileResult compileFile(const WasmEdge_ConfigureContext *Configure,
+                          const std::string &InPath,
+                          const std::string &OutPath);
+
+enum class CacheFillStatus { Compiled, Cached, Busy, Failed };
+
+/// AOT compile the wasm file `InPath` into the cache entry `CachePath`, once
+/// across all processes sharing the cache directory.
+///
+/// An exclusive `flock` on `CachePath + ".lock"` elects one compiler. The
+/// artifact is written to a temporary file and renamed, so readers never see
+/// a partial entry, and processes which waited for the lock find the
+/// finished entry (`Cached`). If `Wait` is false and another process holds
+/// the lock, returns `Busy` at once. `Result` is set for `Compiled` and
+/// `Failed`. An existing entry which `Accept` rejects is checked and
+/// replaced while the lock is held.
+CacheFillStatus
+compileToCache(const WasmEdge_ConfigureContext *Configure,
+               const std::string &InPath, const std::string &CachePath,
+               bool Wait, CompileResult &Result,
+               const std::function<bool(const std::string &)> &Accept =
+                   nullptr);
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,159 @@
+#include "compileworker.h"
+#include "errors.h"
+#include "options.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+CompileAllWorker::CompileAllWorker(Napi::Env Env,
+                                   std::vector<CompileJob> &&Jobs,
+                                   const CompilerOptions &Opts,
+                                   uint32_t Concurrency,
+                                   const Napi::Value &OnProgress)
+    : Napi::AsyncProgressQueueWorker<CompileProgress>(Env),
+      Deferred(Napi::Promise::Deferred::New(Env)), Jobs(std::move(Jobs)),
+      Opts(Opts), Concurrency(Concurrency) {
+  if (OnProgress.IsFunction()) {
+    ProgressCallback = Napi::Persistent(OnProgress.As<Napi::Function>());
+  }
+}
+
+void CompileAllWorker::Execute(const ExecutionProgress &Progress) {
+  std::atomic<uint32_t> Next(0);
+  std::atomic<uint32_t> Completed(0);
+  std::mutex ProgressMutex;
+
+  auto Worker = [&]() {
+    /// Compiler contexts are not shared between threads.
+    WasmEdge_ConfigureContext *Configure = createConfigure(Opts);
+    for (uint32_t I = Next++; I < Jobs.size(); I = Next++) {
+      Jobs[I].Result = compileFile(Configure, Jobs[I].Input, Jobs[I].Output);
+      CompileProgress Event = {I, ++Completed};
+      std::lock_guard<std::mutex> Lock(ProgressMutex);
+      Progress.Send(&Event, 1);
+    }
+    WasmEdge_ConfigureDelete(Configure);
+  };
+
+  uint32_t ThreadCount =
+      std::min(Concurrency, static_cast<uint32_t>(Jobs.size()));
+  std::vector<std::thread> Threads;
+  Threads.reserve(ThreadCount);
+  for (uint32_t I = 0; I < ThreadCount; I++) {
+    Threads.emplace_back(Worker);
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+}
+
+Napi::Object CompileAllWorker::makeResult(Napi::Env Env,
+                                          const CompileJob &Job) const {
+  Napi::Object Result = Napi::Object::New(Env);
+  Result.Set("input", Napi::String::New(Env, Job.Input));
+  Result.Set("output", Napi::String::New(Env, Job.Output));
+  Result.Set("ok", Napi::Boolean::New(Env, Job.Result.Succeeded));
+  if (Job.Result.Succeeded) {
+    Result.Set("error", Env.Null());
+  } else {
+    Napi::Object Error = Napi::Object::New(Env);
+    Error.Set("code", Napi::Number::New(Env, Job.Result.ErrorCode));
+    Error.Set("message", Napi::String::New(Env, Job.Result.ErrorMessage));
+    Result.Set("error", Error);
+  }
+  Result.Set("compileTime", Napi::Number::New(Env, Job.Result.CompileTime));
+  Result.Set("size", Napi::Number::New(
+                         Env, static_cast<double>(Job.Result.OutputSize)));
+  return Result;
+}
+
+void CompileAllWorker::OnProgress(const CompileProgress *Data, size_t Count) {
+  if (ProgressCallback.IsEmpty()) {
+    return;
+  }
+  Napi::Env Env = this->Env();
+  Napi::HandleScope Scope(Env);
+  for (size_t I = 0; I < Count; I++) {
+    Napi::Object Event = makeResult(Env, Jobs[Data[I].Index]);
+    Event.Set("index", Napi::Number::New(Env, Data[I].Index));
+    Event.Set("completed", Napi::Number::New(Env, Data[I].Completed));
+    Event.Set("total", Napi::Number::New(Env, Jobs.size()));
+    ProgressCallback.Call({Event});
+  }
+}
+
+void CompileAllWorker::OnOK() {
+  Napi::Env Env = this->Env();
+  Napi::HandleScope Scope(Env);
+  Napi::Array Results = Napi::Array::New(Env, Jobs.size());
+  for (uint32_t I = 0; I < Jobs.size(); I++) {
+    Results.Set(I, makeResult(Env, Jobs[I]));
+  }
+  Deferred.Resolve(Results);
+}
+
+void CompileAllWorker::OnError(const Napi::Error &Err) {
+  Deferred.Reject(Err.Value());
+}
+
+Napi::Value CompileAll(const Napi::CallbackInfo &Info) {
+  Napi::Env Env = Info.Env();
+  if (Info.Length() < 1 || !Info[0].IsArray()) {
+    napi_throw_error(
+        Env, "Error", ErrorMsgs.at(ErrorType::InvalidCompileJobs).c_str());
+    return Napi::Value();
+  }
+
+  Napi::Array JobList = Info[0].As<Napi::Array>();
+  std::vector<CompileJob> Jobs;
+  Jobs.reserve(JobList.Length());
+  for (uint32_t I = 0; I < JobList.Length(); I++) {
+    Napi::Value Item = JobList[I];
+    if (!Item.IsObject()) {
+      napi_throw_error(
+          Env, "Error", ErrorMsgs.at(ErrorType::InvalidCompileJobs).c_str());
+      return Napi::Value();
+    }
+    Napi::Object Job = Item.As<Napi::Object>();
+    if (!Job.Get("input").IsString() || !Job.Get("output").IsString()) {
+      napi_throw_error(
+          Env, "Error", ErrorMsgs.at(ErrorType::InvalidCompileJobs).c_str());
+      return Napi::Value();
+    }
+    Jobs.push_back({Job.Get("input").As<Napi::String>().Utf8Value(),
+                    Job.Get("output").As<Napi::String>().Utf8Value(),
+                    {false, 0, "", 0.0, 0}});
+  }
+
+  CompilerOptions CompilerOpts;
+  uint32_t Concurrency = std::max(1U, std::thread::hardware_concurrency());
+  Napi::Value OnProgress = Env.Undefined();
+  if (Info.Length() > 1 && Info[1].IsObject()) {
+    Napi::Object Opts = Info[1].As<Napi::Object>();
+    if (!parseCompilerOptions(Opts, CompilerOpts)) {
+      napi_throw_error(Env, "Error",
+                       ErrorMsgs.at(ErrorType::ParseOptionsFailed).c_str());
+      return Napi::Value();
+    }
+    if (Opts.Get("concurrency").IsNumber()) {
+      Concurrency =
+          std::max(1U, Opts.Get("concurrency").As<Napi::Number>().Uint32Value());
+    }
+    OnProgress = Opts.Get("onProgress");
+  }
+
+  CompileAllWorker *Worker =
+      new CompileAllWorker(Env, std::move(Jobs), CompilerOpts, Concurrency,
+                           OnProgress);
+  Napi::Promise Promise = Worker->getPromise();
+  Worker->Queue();
+  return Promise;
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
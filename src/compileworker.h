@@ -0,0 +1,54 @@
+#pragma once
+
+#include "compiler.h"
+
+#include <napi.h>
+#include <string>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+struct CompileJob {
+  std::string Input;
+  std::string Output;
+  CompileResult Result;
+};
+
+struct CompileProgress {
+  uint32_t Index;
+  uint32_t Completed;
+};
+
+/// Run a batch of AOT compilation jobs on a native thread pool.
+/// Progress of every finished job is reported to the optional `onProgress`
+/// callback, and the promise is resolved with the results of all jobs.
+class CompileAllWorker : public Napi::AsyncProgressQueueWorker<CompileProgress> {
+public:
+  CompileAllWorker(Napi::Env Env, std::vector<CompileJob> &&Jobs,
+                   const CompilerOptions &Opts, uint32_t Concurrency,
+                   const Napi::Value &OnProgress);
+
+  Napi::Promise getPromise() const { return Deferred.Promise(); }
+
+protected:
+  void Execute(const ExecutionProgress &Progress) override;
+  void OnProgress(const CompileProgress *Data, size_t Count) override;
+  void OnOK() override;
+  void OnError(const Napi::Error &Err) override;
+
+private:
+  Napi::Object makeResult(Napi::Env Env, const CompileJob &Job) const;
+
+  Napi::Promise::Deferred Deferred;
+  Napi::FunctionReference ProgressCallback;
+  std::vector<CompileJob> Jobs;
+  CompilerOptions Opts;
+  uint32_t Concurrency;
+};
+
+/// JS: compileAll([{input, output}], {concurrency, onProgress}) -> Promise
+Napi::Value CompileAll(const Napi::CallbackInfo &Info);
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -21,6 +21,26 @@ enum class ErrorType {
   InitReactorFailed,
   WasmBindgenMallocFailed,
   WasmBindgenFreeFailed,
+  ReturnTypeMismatch,
+  InvalidCompileJobs,
+  InstanceBusy,
+  ExecutionAborted,
+  InvalidCallOptions,
+  InvalidResultEncoding,
+  QueueFull,
+  DeadlineExceeded,
+  ExtensionLoadFailed,
+  InvalidImports,
+  InvalidCacheBundlePath,
+  InvalidCacheBundle,
+  IncompatibleCacheBundle,
+  InvalidModules,
+  LinkModuleFailed,
+  FileArgumentFailed,
+  ModuleStreamEnded,
+  ModuleStreamNotReady,
+  InvalidPipeline,
+  MemFSFailed,
   NAPIUnkownIntType
 };
 
@@ -46,6 +66,37 @@ const std::map<ErrorType, std::string> ErrorMsgs = {
      "Failed to call wasm-bindgen helper function __wbindgen_malloc"},
     {ErrorType::WasmBindgenFreeFailed,
      "Failed to call wasm-bindgen helper function __wbindgen_free"},
+    {ErrorType::ReturnTypeMismatch,
+     "The return type of the function does not match the called Run method"},
+    {ErrorType::InvalidCompileJobs,
+     "compileAll expects an array of {input, output} file path objects"},
+    {ErrorType::InstanceBusy,
+     "The VM instance is busy with another call"},
+    {ErrorType::ExecutionAborted, "The execution was aborted"},
+    {ErrorType::InvalidCallOptions, "Invalid call options"},
+    {ErrorType::InvalidResultEncoding,
+     "The result of the function is not a valid MessagePack value"},
+    {ErrorType::QueueFull, "The execution queue of the VM instance is full"},
+    {ErrorType::DeadlineExceeded,
+     "The deadline of the execution passed before it could start"},
+    {ErrorType::ExtensionLoadFailed,
+     "Failed to load the WasmEdge extension library"},
+    {ErrorType::InvalidImports,
+     "imports expects an object of module names to objects of functions"},
+    {ErrorType::InvalidCacheBundlePath, "Expected the path of a cache bundle"},
+    {ErrorType::InvalidCacheBundle, "The file is not a valid AOT cache bundle"},
+    {ErrorType::IncompatibleCacheBundle,
+     "The AOT cache bundle was built for another host"},
+    {ErrorType::InvalidModules,
+     "modules expects an object of module names to wasm files or bytecode"},
+    {ErrorType::LinkModuleFailed, "Failed to register the linked module"},
+    {ErrorType::FileArgumentFailed, "Failed to read the file argument"},
+    {ErrorType::ModuleStreamEnded, "The module stream has already ended"},
+    {ErrorType::ModuleStreamNotReady,
+     "The module stream has not finished loading or was already used"},
+    {ErrorType::InvalidPipeline,
+     "Expected an array of stages like [function_name, args...]"},
+    {ErrorType::MemFSFailed, "Failed to create the memfs tree"},
     {ErrorType::NAPIUnkownIntType,
      "WASMEDGE-Napi implementation error: unknown integer type"},
     {ErrorType::UnsupportedArgumentType, "Unsupported argument type"}};
@@ -0,0 +1,122 @@
+#include "extensions.h"
+
+#include <array>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <mutex>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+using CreateImportFn = WasmEdge_ImportObjectContext *(*)();
+
+struct ExtensionInfo {
+  Extension Ext;
+  /// Name of the host module imported by the guest
+  const char *ModuleName;
+  /// Runtime libraries the wrapper needs, loaded first with RTLD_GLOBAL
+  std::vector<const char *> Dependencies;
+  const char *Library;
+  const char *CreateSymbol;
+};
+
+const std::array<ExtensionInfo, 3> &extensionInfos() {
+  static const std::array<ExtensionInfo, 3> Infos = {{
+      {Extension::Image, "wasmedge_image", {}, "libwasmedge-image_c.so",
+       "WasmEdge_Image_ImportObjectCreate"},
+      {Extension::Tensorflow,
+       "wasmedge_tensorflow",
+       {"libtensorflow_framework.so", "libtensorflow.so"},
+       "libwasmedge-tensorflow_c.so",
+       "WasmEdge_Tensorflow_ImportObjectCreate"},
+      {Extension::TensorflowLite,
+       "wasmedge_tensorflowlite",
+       {"libtensorflowlite_c.so"},
+       "libwasmedge-tensorflowlite_c.so",
+       "WasmEdge_TensorflowLite_ImportObjectCreate"},
+  }};
+  return Infos;
+}
+
+/// Libraries stay loaded for the lifetime of the process.
+void *openLibrary(const char *Name, std::string &Error) {
+  if (void *Handle = dlopen(Name, RTLD_LAZY | RTLD_GLOBAL)) {
+    return Handle;
+  }
+  Error = dlerror();
+  if (const char *Home = std::getenv("HOME")) {
+    std::string Path = std::string(Home) + "/.wasmedge/lib/" + Name;
+    if (void *Handle = dlopen(Path.c_str(), RTLD_LAZY | RTLD_GLOBAL)) {
+      Error.clear();
+      return Handle;
+    }
+  }
+  return nullptr;
+}
+
+std::mutex Mutex;
+std::array<CreateImportFn, 3> CreateFns{};
+
+} // namespace
+
+std::vector<Extension>
+requiredExtensions(const std::vector<const WasmEdge_ASTModuleContext *> &ASTs) {
+  std::vector<Extension> Required;
+  std::vector<const WasmEdge_ImportTypeContext *> Imports;
+  for (const auto *AST : ASTs) {
+    const uint32_t Len = WasmEdge_ASTModuleListImportsLength(AST);
+    const size_t Begin = Imports.size();
+    Imports.resize(Begin + Len);
+    WasmEdge_ASTModuleListImports(AST, Imports.data() + Begin, Len);
+  }
+  for (const auto &Info : extensionInfos()) {
+    WasmEdge_String Name = WasmEdge_StringWrap(
+        Info.ModuleName, std::char_traits<char>::length(Info.ModuleName));
+    for (const auto *Import : Imports) {
+      if (WasmEdge_StringIsEqual(WasmEdge_ImportTypeGetModuleName(Import),
+                                 Name)) {
+        Required.push_back(Info.Ext);
+        break;
+      }
+    }
+  }
+  return Required;
+}
+
+WasmEdge_ImportObjectContext *createExtensionImport(Extension Ext,
+                                                    std::string &Error) {
+  const auto Index = static_cast<size_t>(Ext);
+  const ExtensionInfo &Info = extensionInfos()[Index];
+  CreateImportFn Create;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (CreateFns[Index] == nullptr) {
+      for (const char *Dependency : Info.Dependencies) {
+        if (openLibrary(Dependency, Error) == nullptr) {
+          return nullptr;
+        }
+      }
+      void *Handle = openLibrary(Info.Library, Error);
+      if (Handle == nullptr) {
+        return nullptr;
+      }
+      void *Symbol = dlsym(Handle, Info.CreateSymbol);
+      if (Symbol == nullptr) {
+        Error = dlerror();
+        return nullptr;
+      }
+      CreateFns[Index] = reinterpret_cast<CreateImportFn>(Symbol);
+    }
+    Create = CreateFns[Index];
+  }
+  WasmEdge_ImportObjectContext *Import = Create();
+  if (Import == nullptr) {
+    Error = std::string(Info.CreateSymbol) + " failed";
+  }
+  return Import;
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
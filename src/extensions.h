@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Host modules provided by the WasmEdge extension libraries.
+enum class Extension { Image, Tensorflow, TensorflowLite };
+
+/// The extensions whose host modules are imported by any of the modules.
+std::vector<Extension>
+requiredExtensions(const std::vector<const WasmEdge_ASTModuleContext *> &ASTs);
+
+/// Create the import object of an extension.
+///
+/// The extension libraries and the TensorFlow runtimes they depend on are
+/// not linked into the addon: they are loaded with `dlopen` the first time
+/// a module imports them, from the library search path or else from
+/// `$HOME/.wasmedge/lib`. Returns nullptr and sets `Error` if a library or
+/// symbol cannot be found; the failure is not cached, so a later call can
+/// succeed once the library is installed.
+WasmEdge_ImportObjectContext *createExtensionImport(Extension Ext,
+                                                    std::string &Error);
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,114 @@
+#include "filearg.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+bool getUInt64(const Napi::Object &Object, const char *Key, uint64_t &Value) {
+  if (!Object.Has(Key) || Object.Get(Key).IsUndefined()) {
+    return true;
+  }
+  Napi::Value Prop = Object.Get(Key);
+  if (Prop.IsBigInt()) {
+    bool Lossless = false;
+    Value = Prop.As<Napi::BigInt>().Uint64Value(&Lossless);
+    return Lossless;
+  }
+  if (!Prop.IsNumber()) {
+    return false;
+  }
+  const double Number = Prop.As<Napi::Number>().DoubleValue();
+  if (!(Number >= 0) || Number != std::floor(Number) || Number > 0x1p53) {
+    return false;
+  }
+  Value = static_cast<uint64_t>(Number);
+  return true;
+}
+
+} // namespace
+
+FileArgument::~FileArgument() {
+  if (Fd >= 0) {
+    close(Fd);
+  }
+}
+
+bool FileArgument::is(const Napi::Value &Value) {
+  return Value.IsObject() && !Value.IsTypedArray() &&
+         Value.As<Napi::Object>().Has("file");
+}
+
+bool FileArgument::open(const Napi::Object &Object, std::string &Error) {
+  Napi::Value File = Object.Get("file");
+  uint64_t Length = std::numeric_limits<uint64_t>::max();
+  if (!File.IsString() || !getUInt64(Object, "offset", Offset) ||
+      !getUInt64(Object, "length", Length)) {
+    Error = "expected {file: String, offset: Integer, length: Integer}";
+    return false;
+  }
+  Path = File.As<Napi::String>().Utf8Value();
+
+  Fd = ::open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat Stat;
+  if (Fd < 0 || fstat(Fd, &Stat) != 0) {
+    Error = Path + ": " + std::strerror(errno);
+    return false;
+  }
+  if (!S_ISREG(Stat.st_mode)) {
+    Error = Path + ": not a regular file";
+    return false;
+  }
+  const uint64_t FileSize = static_cast<uint64_t>(Stat.st_size);
+  if (Offset > FileSize) {
+    Error = Path + ": offset beyond the end of the file";
+    return false;
+  }
+  if (Length == std::numeric_limits<uint64_t>::max()) {
+    Length = FileSize - Offset;
+  }
+  if (Length > FileSize - Offset) {
+    Error = Path + ": range beyond the end of the file";
+    return false;
+  }
+  if (Length > std::numeric_limits<uint32_t>::max()) {
+    Error = Path + ": range larger than the guest memory";
+    return false;
+  }
+  Size = static_cast<uint32_t>(Length);
+  return true;
+}
+
+bool FileArgument::read(uint8_t *Dest, std::string &Error) {
+  /// Read ahead aggressively, the range is consumed once from start to end.
+  posix_fadvise(Fd, static_cast<off_t>(Offset), Size, POSIX_FADV_SEQUENTIAL);
+  uint64_t Done = 0;
+  while (Done < Size) {
+    ssize_t Res = pread(Fd, Dest + Done, Size - Done,
+                        static_cast<off_t>(Offset + Done));
+    if (Res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (Res < 0) {
+      Error = Path + ": " + std::strerror(errno);
+      return false;
+    }
+    if (Res == 0) {
+      Error = Path + ": file truncated while reading";
+      return false;
+    }
+    Done += static_cast<uint64_t>(Res);
+  }
+  return true;
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <napi.h>
+#include <string>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// A byte range of a host file given as an argument,
+/// `{file: path, offset, length}`. The range is read from native code into
+/// the guest allocation, so large inputs do not pass through the V8 heap.
+class FileArgument {
+public:
+  FileArgument() = default;
+  ~FileArgument();
+  FileArgument(const FileArgument &) = delete;
+  FileArgument &operator=(const FileArgument &) = delete;
+
+  /// Whether `Value` is an object with a `file` property.
+  static bool is(const Napi::Value &Value);
+
+  /// Parse the argument, open the file and resolve the length of the range.
+  /// `offset` defaults to 0 and `length` to the rest of the file. Returns
+  /// false and sets `Error` if the argument is malformed, the file cannot be
+  /// opened or the range exceeds the file or 4 GiB.
+  bool open(const Napi::Object &Object, std::string &Error);
+
+  uint32_t getSize() const noexcept { return Size; }
+
+  /// Read the range into `Dest`, which holds at least getSize() bytes.
+  bool read(uint8_t *Dest, std::string &Error);
+
+private:
+  std::string Path;
+  int Fd = -1;
+  uint64_t Offset = 0;
+  uint32_t Size = 0;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
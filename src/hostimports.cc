@@ -0,0 +1,241 @@
+#include "hostimports.h"
+#include "values.h"
+
+#include <algorithm>
+#include <set>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+HostCallTrampoline::HostCallTrampoline(Napi::Env Env)
+    : Env(Env), JSThread(std::this_thread::get_id()) {
+  TSFN = Napi::ThreadSafeFunction::New(Env, Napi::Function(),
+                                       "WasmEdgeHostCall", 0, 1);
+  /// Only running guests keep the event loop alive, not the trampoline.
+  TSFN.Unref(Env);
+  napi_add_env_cleanup_hook(Env, close, this);
+}
+
+HostCallTrampoline::~HostCallTrampoline() {
+  napi_remove_env_cleanup_hook(Env, close, this);
+  close(this);
+  TSFN.Release();
+}
+
+void HostCallTrampoline::close(void *Self) {
+  auto &Trampoline = *static_cast<HostCallTrampoline *>(Self);
+  std::lock_guard<std::mutex> Lock(Trampoline.Mutex);
+  Trampoline.Closed = true;
+  /// The requests live on the stacks of the waiting threads, which return
+  /// once they see Closed.
+  Trampoline.Pending.clear();
+  Trampoline.Cond.notify_all();
+}
+
+bool HostCallTrampoline::call(const std::function<void(Napi::Env)> &Fn) {
+  Calls++;
+  if (isJSThread()) {
+    Fn(Env);
+    return true;
+  }
+
+  Request Req{&Fn};
+  std::unique_lock<std::mutex> Lock(Mutex);
+  if (Closed) {
+    return false;
+  }
+  Pending.push_back(&Req);
+  if (!Scheduled) {
+    napi_status Status = TSFN.NonBlockingCall(
+        [this](Napi::Env Env, Napi::Function) { drain(Env); });
+    if (Status != napi_ok) {
+      Pending.pop_back();
+      return false;
+    }
+    Scheduled = true;
+  }
+  /// Without the close check a guest would hang forever when the env goes
+  /// away before the drain runs; instead its host function traps.
+  Cond.wait(Lock, [this, &Req]() { return Req.Done || Closed; });
+  return Req.Done;
+}
+
+void HostCallTrampoline::drain(Napi::Env Env) {
+  std::vector<Request *> Batch;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Batch.swap(Pending);
+    Scheduled = false;
+  }
+  Batches++;
+  for (Request *Req : Batch) {
+    {
+      Napi::HandleScope Scope(Env);
+      (*Req->Fn)(Env);
+    }
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Req->Done = true;
+    Cond.notify_all();
+  }
+}
+
+JSImportModule::JSImportModule(Napi::Env Env, const std::string &Name,
+                               const Napi::Object &Functions,
+                               HostCallTrampoline &Trampoline)
+    : Name(Name), Trampoline(Trampoline) {
+  Napi::Array Keys = Functions.GetPropertyNames();
+  for (uint32_t I = 0; I < Keys.Length(); I++) {
+    Napi::Value Value = Functions.Get(Keys.Get(I));
+    if (!Value.IsFunction()) {
+      continue;
+    }
+    auto Func = std::make_unique<HostFunc>();
+    Func->Module = this;
+    Func->Name = Keys.Get(I).ToString().Utf8Value();
+    Func->Fn = Napi::Persistent(Value.As<Napi::Function>());
+    Funcs.emplace(Func->Name, std::move(Func));
+  }
+
+  Napi::Object Self = Napi::Object::New(Env);
+  napi_property_descriptor Memory = {
+      "memory", nullptr, nullptr, getMemory, nullptr, nullptr,
+      napi_enumerable, this};
+  Self.DefineProperties({Memory});
+  Receiver = Napi::Persistent(Self);
+}
+
+WasmEdge_ImportObjectContext *JSImportModule::createImport(
+    const std::vector<const WasmEdge_ASTModuleContext *> &ASTs) {
+  WasmEdge_String ModuleName =
+      WasmEdge_StringWrap(Name.data(), static_cast<uint32_t>(Name.size()));
+  WasmEdge_ImportObjectContext *Import = nullptr;
+  std::set<std::string> Added;
+  for (const auto *AST : ASTs) {
+    const uint32_t Len = WasmEdge_ASTModuleListImportsLength(AST);
+    std::vector<const WasmEdge_ImportTypeContext *> Imports(Len);
+    WasmEdge_ASTModuleListImports(AST, Imports.data(), Len);
+
+    for (const auto *ImpType : Imports) {
+      if (WasmEdge_ImportTypeGetExternalType(ImpType) !=
+              WasmEdge_ExternalType_Function ||
+          !WasmEdge_StringIsEqual(WasmEdge_ImportTypeGetModuleName(ImpType),
+                                  ModuleName)) {
+        continue;
+      }
+      WasmEdge_String FuncName = WasmEdge_ImportTypeGetExternalName(ImpType);
+      std::string Key(FuncName.Buf, FuncName.Length);
+      auto It = Funcs.find(Key);
+      const WasmEdge_FunctionTypeContext *FuncType =
+          WasmEdge_ImportTypeGetFunctionType(AST, ImpType);
+      /// Missing functions are left to fail at instantiation with the name
+      /// of the import, a later importer with another signature likewise.
+      if (It == Funcs.end() || FuncType == nullptr ||
+          !Added.insert(Key).second) {
+        continue;
+      }
+      HostFunc &Func = *It->second;
+      Func.Params.resize(WasmEdge_FunctionTypeGetParametersLength(FuncType));
+      WasmEdge_FunctionTypeGetParameters(FuncType, Func.Params.data(),
+                                         Func.Params.size());
+      Func.Returns.resize(WasmEdge_FunctionTypeGetReturnsLength(FuncType));
+      WasmEdge_FunctionTypeGetReturns(FuncType, Func.Returns.data(),
+                                      Func.Returns.size());
+
+      if (Import == nullptr) {
+        Import = WasmEdge_ImportObjectCreate(ModuleName);
+      }
+      WasmEdge_HostFunctionContext *HostFunc =
+          WasmEdge_HostFunctionCreate(FuncType, callHost, &Func, 0);
+      WasmEdge_ImportObjectAddHostFunction(Import, FuncName, HostFunc);
+    }
+  }
+  return Import;
+}
+
+WasmEdge_Result
+JSImportModule::callHost(void *Data, WasmEdge_MemoryInstanceContext *MemCxt,
+                         const WasmEdge_Value *Params,
+                         WasmEdge_Value *Returns) {
+  HostFunc &Func = *static_cast<HostFunc *>(Data);
+  JSImportModule &Module = *Func.Module;
+  const bool Sync = Module.Trampoline.isJSThread();
+  bool Succeeded = false;
+  const bool Called = Module.Trampoline.call([&](Napi::Env Env) {
+    Succeeded = Module.invoke(Env, Func, MemCxt, Params, Returns);
+    /// A synchronous Run method rethrows the exception of the function. For
+    /// RunAsync the call fails with ExecutionFailed.
+    if (!Sync && Env.IsExceptionPending()) {
+      Env.GetAndClearPendingException();
+    }
+  });
+  return Called && Succeeded ? WasmEdge_Result_Success : WasmEdge_Result_Fail;
+}
+
+bool JSImportModule::invoke(Napi::Env Env, HostFunc &Func,
+                            WasmEdge_MemoryInstanceContext *MemCxt,
+                            const WasmEdge_Value *Params,
+                            WasmEdge_Value *Returns) {
+  std::vector<napi_value> Args;
+  Args.reserve(Func.Params.size());
+  for (size_t I = 0; I < Func.Params.size(); I++) {
+    WasmEdge_Value Param = Params[I];
+    Param.Type = Func.Params[I];
+    Args.push_back(toNapiValue(Env, Param));
+  }
+
+  CurrentMemory = MemCxt;
+  Napi::Value Result = Func.Fn.Call(Receiver.Value(), Args);
+  CurrentMemory = nullptr;
+  if (!MemoryBuffer.IsEmpty()) {
+    /// The linear memory may move when it grows, drop the view with the call.
+    napi_detach_arraybuffer(Env, MemoryBuffer.Value());
+    MemoryBuffer.Reset();
+  }
+  if (Env.IsExceptionPending()) {
+    return false;
+  }
+
+  if (Func.Returns.size() == 1) {
+    return toWasmEdgeValue(Result, Func.Returns[0], Returns[0]);
+  }
+  if (Func.Returns.size() > 1) {
+    if (!Result.IsArray() ||
+        Result.As<Napi::Array>().Length() != Func.Returns.size()) {
+      return false;
+    }
+    Napi::Array Results = Result.As<Napi::Array>();
+    for (uint32_t I = 0; I < Func.Returns.size(); I++) {
+      if (!toWasmEdgeValue(Results.Get(I), Func.Returns[I], Returns[I])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+napi_value JSImportModule::getMemory(napi_env Env, napi_callback_info Info) {
+  void *Data = nullptr;
+  napi_get_cb_info(Env, Info, nullptr, nullptr, nullptr, &Data);
+  JSImportModule &Module = *static_cast<JSImportModule *>(Data);
+  if (Module.CurrentMemory == nullptr) {
+    return Napi::Env(Env).Undefined();
+  }
+  if (Module.MemoryBuffer.IsEmpty()) {
+    const uint32_t Size = static_cast<uint32_t>(std::min<uint64_t>(
+        uint64_t(WasmEdge_MemoryInstanceGetPageSize(Module.CurrentMemory)) *
+            65536,
+        UINT32_MAX));
+    uint8_t *Base =
+        WasmEdge_MemoryInstanceGetPointer(Module.CurrentMemory, 0, Size);
+    if (Base == nullptr) {
+      return Napi::Env(Env).Undefined();
+    }
+    Module.MemoryBuffer =
+        Napi::Persistent(Napi::ArrayBuffer::New(Env, Base, Size));
+  }
+  Napi::ArrayBuffer Buffer = Module.MemoryBuffer.Value();
+  return Napi::Uint8Array::New(Env, Buffer.ByteLength(), Buffer, 0);
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
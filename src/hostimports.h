@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Runs host calls of guests executing on other threads (RunAsync) on the
+/// JS thread of a `napi_env`, and blocks the guest until they return.
+///
+/// Requests are queued and a single thread-safe function call drains all of
+/// them, so guests calling back at the same time share one wakeup of the
+/// event loop instead of taking turns. Calls made on the JS thread itself
+/// run directly.
+class HostCallTrampoline {
+public:
+  explicit HostCallTrampoline(Napi::Env Env);
+  ~HostCallTrampoline();
+  HostCallTrampoline(const HostCallTrampoline &) = delete;
+  HostCallTrampoline &operator=(const HostCallTrampoline &) = delete;
+
+  /// Run `Fn` on the JS thread and wait for it. Returns false if the env is
+  /// shutting down and `Fn` was not run; a waiting call is woken up then.
+  bool call(const std::function<void(Napi::Env)> &Fn);
+
+  bool isJSThread() const noexcept {
+    return std::this_thread::get_id() == JSThread;
+  }
+  uint64_t getCalls() const noexcept { return Calls; }
+  uint64_t getBatches() const noexcept { return Batches; }
+
+private:
+  struct Request {
+    const std::function<void(Napi::Env)> *Fn;
+    bool Done = false;
+  };
+
+  void drain(Napi::Env Env);
+  /// Fail the pending and all further calls. Env cleanup hook.
+  static void close(void *Self);
+
+  Napi::Env Env;
+  std::thread::id JSThread;
+  Napi::ThreadSafeFunction TSFN;
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  std::vector<Request *> Pending;
+  bool Scheduled = false;
+  /// The env is torn down, queued drains will never run.
+  bool Closed = false;
+  std::atomic<uint64_t> Calls{0};
+  std::atomic<uint64_t> Batches{0};
+};
+
+/// A host module of JS functions given in the `imports` option, e.g.
+/// `{env: {lookup(key) {...}}}`.
+///
+/// The signatures are taken from the imports of the guest. Parameters are
+/// passed as Numbers (i32, f32, f64) and BigInts (i64); the result is
+/// converted to the declared return type, an array is expected for several
+/// return values. During the call `this.memory` is a Uint8Array view of the
+/// linear memory of the guest. It is detached when the function returns.
+class JSImportModule {
+public:
+  JSImportModule(Napi::Env Env, const std::string &Name,
+                 const Napi::Object &Functions,
+                 HostCallTrampoline &Trampoline);
+  JSImportModule(const JSImportModule &) = delete;
+  JSImportModule &operator=(const JSImportModule &) = delete;
+
+  const std::string &getName() const noexcept { return Name; }
+
+  /// Create the import object with the functions of this module imported by
+  /// any of `ASTs`, the main module and the modules it links. A function is
+  /// added once, with the signature of its first importer. Returns nullptr
+  /// if none of them imports a function of this module.
+  WasmEdge_ImportObjectContext *
+  createImport(const std::vector<const WasmEdge_ASTModuleContext *> &ASTs);
+
+private:
+  struct HostFunc {
+    JSImportModule *Module;
+    std::string Name;
+    Napi::FunctionReference Fn;
+    std::vector<WasmEdge_ValType> Params, Returns;
+  };
+
+  static WasmEdge_Result callHost(void *Data,
+                                  WasmEdge_MemoryInstanceContext *MemCxt,
+                                  const WasmEdge_Value *Params,
+                                  WasmEdge_Value *Returns);
+  /// Requires the JS thread.
+  bool invoke(Napi::Env Env, HostFunc &Func,
+              WasmEdge_MemoryInstanceContext *MemCxt,
+              const WasmEdge_Value *Params, WasmEdge_Value *Returns);
+  static napi_value getMemory(napi_env Env, napi_callback_info Info);
+
+  std::string Name;
+  HostCallTrampoline &Trampoline;
+  std::map<std::string, std::unique_ptr<HostFunc>> Funcs;
+  /// `this` of the JS functions
+  Napi::ObjectReference Receiver;
+  /// Memory of the guest while a function is called
+  WasmEdge_MemoryInstanceContext *CurrentMemory = nullptr;
+  Napi::Reference<Napi::ArrayBuffer> MemoryBuffer;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
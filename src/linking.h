@@ -0,0 +1,29 @@
+#pragma once
+
+#include "bytecode.h"
+#include "cache.h"
+#include "registry.h"
+
+#include <memory>
+#include <string>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// A named wasm module given in the `modules` option, which the main module
+/// imports from.
+///
+/// Like the main module it is compiled into the AoT cache, parsed once per
+/// process through the `ModuleRegistry` and skips validation with
+/// `TrustValidated`. Every VM instantiates it in its own store under `Name`
+/// before the main module, so its globals and memory are per instance while
+/// the code is shared.
+struct LinkedModule {
+  std::string Name;
+  Bytecode BC;
+  WASMEDGE::NAPI::Cache Cache;
+  std::shared_ptr<const SharedModule> Module;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
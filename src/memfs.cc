@@ -0,0 +1,259 @@
+#include "memfs.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/functional/hash.hpp>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+/// Registry of the shared layers of the process. The base directory is
+/// removed on exit, also covering instances which were never finalized.
+struct LayerRegistry {
+  std::mutex Mutex;
+  std::multimap<size_t, std::weak_ptr<MemFSLayer>> Layers;
+  /// Empty if no private base directory could be created.
+  std::filesystem::path Base;
+  uint64_t Counter = 0;
+
+  LayerRegistry() {
+    std::error_code EC;
+    std::filesystem::path Root = "/dev/shm";
+    if (!std::filesystem::is_directory(Root, EC)) {
+      Root = std::filesystem::temp_directory_path(EC);
+      if (EC) {
+        return;
+      }
+    }
+    /// The root is world-writable, so the name must not be guessable and
+    /// the directory is checked to be ours alone, as in validation.cc.
+    std::string Template = (Root / "wasmedge-memfs-XXXXXX").string();
+    if (mkdtemp(Template.data()) == nullptr) {
+      return;
+    }
+    struct stat Stat;
+    if (lstat(Template.c_str(), &Stat) != 0 || !S_ISDIR(Stat.st_mode) ||
+        Stat.st_uid != geteuid() || (Stat.st_mode & 0077) != 0) {
+      return;
+    }
+    Base = Template;
+  }
+  ~LayerRegistry() { removeMemFSTree(Base.string()); }
+
+  /// A new directory below the base, or an empty path on failure.
+  std::filesystem::path next(const char *Kind) {
+    if (Base.empty()) {
+      return {};
+    }
+    return Base / (std::string(Kind) + "-" + std::to_string(Counter++));
+  }
+};
+
+LayerRegistry &registry() {
+  static LayerRegistry Registry;
+  return Registry;
+}
+
+bool isValidRelativePath(const std::filesystem::path &Path) {
+  if (Path.empty() || Path.is_absolute()) {
+    return false;
+  }
+  for (const auto &Part : Path) {
+    if (Part == "..") {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Whether the process ignores file mode bits, i.e. runs as root or with
+/// CAP_DAC_OVERRIDE.
+bool bypassesPermissions() {
+  if (geteuid() == 0) {
+    return true;
+  }
+  std::ifstream Status("/proc/self/status");
+  std::string Line;
+  while (std::getline(Status, Line)) {
+    if (Line.compare(0, 7, "CapEff:") == 0) {
+      const uint64_t Caps = std::strtoull(Line.c_str() + 7, nullptr, 16);
+      /// CAP_DAC_OVERRIDE is capability 1.
+      return (Caps & (UINT64_C(1) << 1)) != 0;
+    }
+  }
+  return false;
+}
+
+/// Check that `Layer` holds exactly `Files`. Hash keys can collide, so the
+/// paths and the bytes on disk are compared on every registry hit.
+bool holdsFiles(const MemFSLayer &Layer, const std::vector<MemFSFile> &Files) {
+  if (Layer.getFiles().size() != Files.size()) {
+    return false;
+  }
+  std::vector<char> Buffer(64 * 1024);
+  for (size_t I = 0; I < Files.size(); I++) {
+    if (Layer.getFiles()[I] != Files[I].Path) {
+      return false;
+    }
+    std::filesystem::path Target =
+        std::filesystem::path(Layer.getPath()) / Files[I].Path;
+    std::error_code EC;
+    if (std::filesystem::file_size(Target, EC) != Files[I].Size || EC) {
+      return false;
+    }
+    std::ifstream In(Target, std::ios::binary);
+    size_t Offset = 0;
+    while (Offset < Files[I].Size) {
+      In.read(Buffer.data(),
+              std::min(Buffer.size(), Files[I].Size - Offset));
+      const size_t Read = In.gcount();
+      if (Read == 0 ||
+          std::memcmp(Buffer.data(), Files[I].Data + Offset, Read) != 0) {
+        return false;
+      }
+      Offset += Read;
+    }
+  }
+  return true;
+}
+
+void setTreePermissions(const std::filesystem::path &Dir, bool Writable) {
+  using std::filesystem::perms;
+  std::error_code EC;
+  const perms Write = perms::owner_write;
+  const auto Option = Writable ? std::filesystem::perm_options::add
+                               : std::filesystem::perm_options::remove;
+  for (auto It = std::filesystem::recursive_directory_iterator(Dir, EC);
+       !EC && It != std::filesystem::recursive_directory_iterator();
+       It.increment(EC)) {
+    std::filesystem::permissions(It->path(), Write, Option, EC);
+  }
+  std::filesystem::permissions(Dir, Write, Option, EC);
+}
+
+} // namespace
+
+MemFSLayer::~MemFSLayer() { removeMemFSTree(Path); }
+
+std::shared_ptr<MemFSLayer>
+shareMemFSLayer(const std::vector<MemFSFile> &Files, bool Preopened) {
+  size_t Key = Files.size();
+  std::vector<std::string> Paths;
+  Paths.reserve(Files.size());
+  for (const auto &File : Files) {
+    if (!isValidRelativePath(File.Path)) {
+      return nullptr;
+    }
+    boost::hash_combine(Key, File.Path);
+    boost::hash_combine(Key,
+                        boost::hash_range(File.Data, File.Data + File.Size));
+    Paths.push_back(File.Path);
+  }
+  static const bool Private = bypassesPermissions();
+  const bool Shared = !Preopened || !Private;
+
+  LayerRegistry &Registry = registry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  for (auto It = Registry.Layers.begin(); It != Registry.Layers.end();) {
+    if (It->second.expired()) {
+      It = Registry.Layers.erase(It);
+    } else {
+      ++It;
+    }
+  }
+  if (Shared) {
+    auto Range = Registry.Layers.equal_range(Key);
+    for (auto It = Range.first; It != Range.second; ++It) {
+      auto Layer = It->second.lock();
+      if (Layer && holdsFiles(*Layer, Files)) {
+        return Layer;
+      }
+    }
+  }
+
+  std::error_code EC;
+  std::filesystem::path Dir = Registry.next("ro");
+  if (Dir.empty() || !std::filesystem::create_directory(Dir, EC) || EC) {
+    return nullptr;
+  }
+  auto Layer = std::make_shared<MemFSLayer>(Dir.string(), std::move(Paths));
+  for (const auto &File : Files) {
+    std::filesystem::path Target = Dir / File.Path;
+    std::filesystem::create_directories(Target.parent_path(), EC);
+    std::ofstream Out(Target, std::ios::binary | std::ios::trunc);
+    Out.write(reinterpret_cast<const char *>(File.Data), File.Size);
+    if (EC || !Out) {
+      return nullptr;
+    }
+  }
+  setTreePermissions(Dir, false);
+  if (Shared) {
+    Registry.Layers.emplace(Key, Layer);
+  }
+  return Layer;
+}
+
+std::string createMemFSOverlay(const MemFSLayer &Template) {
+  LayerRegistry &Registry = registry();
+  std::filesystem::path Dir;
+  {
+    std::lock_guard<std::mutex> Lock(Registry.Mutex);
+    Dir = Registry.next("rw");
+  }
+  std::error_code EC;
+  if (Dir.empty()) {
+    return "";
+  }
+  std::filesystem::copy(Template.getPath(), Dir,
+                        std::filesystem::copy_options::recursive, EC);
+  if (EC) {
+    removeMemFSTree(Dir.string());
+    return "";
+  }
+  setTreePermissions(Dir, true);
+  return Dir.string();
+}
+
+bool collectMemFSFiles(const std::string &Dir, const std::string &Prefix,
+                       std::map<std::string, std::vector<uint8_t>> &Files) {
+  std::error_code EC;
+  for (auto It = std::filesystem::recursive_directory_iterator(Dir, EC);
+       !EC && It != std::filesystem::recursive_directory_iterator();
+       It.increment(EC)) {
+    if (!It->is_regular_file(EC)) {
+      continue;
+    }
+    std::ifstream In(It->path(), std::ios::binary);
+    std::vector<uint8_t> Data(It->file_size(EC));
+    In.read(reinterpret_cast<char *>(Data.data()), Data.size());
+    Data.resize(In.gcount());
+    std::string Name =
+        std::filesystem::relative(It->path(), Dir, EC).generic_string();
+    if (!Prefix.empty() && Prefix.back() != '/') {
+      Name = "/" + Name;
+    }
+    Files[Prefix + Name] = std::move(Data);
+  }
+  return !EC;
+}
+
+void removeMemFSTree(const std::string &Dir) {
+  std::error_code EC;
+  if (Dir.empty() || !std::filesystem::exists(Dir, EC)) {
+    return;
+  }
+  setTreePermissions(Dir, true);
+  std::filesystem::remove_all(Dir, EC);
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
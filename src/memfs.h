@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// A file to be placed into a memfs tree. `Data` is only borrowed while the
+/// tree is written.
+struct MemFSFile {
+  std::string Path;
+  const uint8_t *Data;
+  size_t Size;
+};
+
+/// A read-only directory tree on tmpfs (`/dev/shm`) which is preopened for
+/// WASI guests. WasmEdge can only preopen host directories, so memfs trees
+/// live in the page cache instead of the addon heap.
+///
+/// Layers are content addressed: instances of the process which are given
+/// the same files share one tree, which is removed with its last user.
+class MemFSLayer {
+public:
+  MemFSLayer(std::string Path, std::vector<std::string> Files)
+      : Path(std::move(Path)), Files(std::move(Files)) {}
+  ~MemFSLayer();
+  MemFSLayer(const MemFSLayer &) = delete;
+  MemFSLayer &operator=(const MemFSLayer &) = delete;
+
+  const std::string &getPath() const noexcept { return Path; }
+  /// Relative paths of the files, in the order they were given.
+  const std::vector<std::string> &getFiles() const noexcept { return Files; }
+
+private:
+  std::string Path;
+  std::vector<std::string> Files;
+};
+
+/// Get or create the shared read-only layer holding `Files`. Returns nullptr
+/// if a path is invalid (absolute or containing `..`) or writing failed.
+///
+/// A layer which is `Preopened` to guests is only shared if the process is
+/// subject to file permissions. Root (or CAP_DAC_OVERRIDE) ignores the
+/// read-only mode and WASI preopens can not be restricted through the C API,
+/// so such a process gets a private layer per call of this function.
+std::shared_ptr<MemFSLayer> shareMemFSLayer(const std::vector<MemFSFile> &Files,
+                                            bool Preopened);
+
+/// Create a private writable copy of `Template` for one call. Returns an
+/// empty string on failure.
+std::string createMemFSOverlay(const MemFSLayer &Template);
+
+/// Read all regular files below `Dir` into `Files`, keyed by `Prefix` joined
+/// with the path relative to `Dir`.
+bool collectMemFSFiles(const std::string &Dir, const std::string &Prefix,
+                       std::map<std::string, std::vector<uint8_t>> &Files);
+
+/// Remove a tree created by createMemFSOverlay.
+void removeMemFSTree(const std::string &Dir);
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,238 @@
+#include "memoize.h"
+#include "filearg.h"
+#include "msgpack.h"
+
+#include <cstring>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+template <typename T> void appendRaw(std::string &Key, const T &Value) {
+  Key.append(reinterpret_cast<const char *>(&Value), sizeof(T));
+}
+
+void appendBytes(std::string &Key, char Tag, const void *Data, size_t Size) {
+  Key.push_back(Tag);
+  appendRaw(Key, static_cast<uint64_t>(Size));
+  Key.append(static_cast<const char *>(Data), Size);
+}
+
+} // namespace
+
+bool MemoValue::capture(Napi::Env Env, const Napi::Value &Value) {
+  if (Value.IsUndefined()) {
+    Type = Kind::Undefined;
+  } else if (Value.IsNull()) {
+    Type = Kind::Null;
+  } else if (Value.IsBoolean()) {
+    Type = Kind::Boolean;
+    Scalar.Bool = Value.As<Napi::Boolean>().Value();
+  } else if (Value.IsNumber()) {
+    Type = Kind::Number;
+    Scalar.Number = Value.As<Napi::Number>().DoubleValue();
+  } else if (Value.IsBigInt()) {
+    bool Lossless = false;
+    Scalar.Int = Value.As<Napi::BigInt>().Int64Value(&Lossless);
+    Type = Kind::BigInt;
+    if (!Lossless) {
+      Scalar.UInt = Value.As<Napi::BigInt>().Uint64Value(&Lossless);
+      Type = Kind::BigUInt;
+    }
+    return Lossless;
+  } else if (Value.IsString()) {
+    Type = Kind::String;
+    Bytes = Value.As<Napi::String>().Utf8Value();
+  } else if (Value.IsTypedArray() &&
+             Value.As<Napi::TypedArray>().TypedArrayType() ==
+                 napi_uint8_array) {
+    Napi::Uint8Array Array = Value.As<Napi::Uint8Array>();
+    Type = Kind::Bytes;
+    Bytes.assign(reinterpret_cast<const char *>(Array.Data()),
+                 Array.ByteLength());
+  } else if (Value.IsArray()) {
+    Napi::Array Array = Value.As<Napi::Array>();
+    Type = Kind::Array;
+    Items.resize(Array.Length());
+    for (uint32_t I = 0; I < Array.Length(); I++) {
+      if (!Items[I].capture(Env, Array.Get(I))) {
+        return false;
+      }
+    }
+  } else {
+    /// Objects of RunValue
+    std::vector<uint8_t> Encoded;
+    if (!encodeMsgPack(Env, Value, Encoded)) {
+      return false;
+    }
+    Type = Kind::MsgPack;
+    Bytes.assign(Encoded.begin(), Encoded.end());
+  }
+  return true;
+}
+
+bool MemoValue::restore(Napi::Env Env, Napi::Value &Out) const {
+  switch (Type) {
+  case Kind::Undefined:
+    Out = Env.Undefined();
+    return true;
+  case Kind::Null:
+    Out = Env.Null();
+    return true;
+  case Kind::Boolean:
+    Out = Napi::Boolean::New(Env, Scalar.Bool);
+    return true;
+  case Kind::Number:
+    Out = Napi::Number::New(Env, Scalar.Number);
+    return true;
+  case Kind::BigInt:
+    Out = Napi::BigInt::New(Env, Scalar.Int);
+    return true;
+  case Kind::BigUInt:
+    Out = Napi::BigInt::New(Env, Scalar.UInt);
+    return true;
+  case Kind::String:
+    Out = Napi::String::New(Env, Bytes);
+    return true;
+  case Kind::Bytes: {
+    Napi::Uint8Array Array = Napi::Uint8Array::New(Env, Bytes.size());
+    std::memcpy(Array.Data(), Bytes.data(), Bytes.size());
+    Out = Array;
+    return true;
+  }
+  case Kind::Array: {
+    Napi::Array Array = Napi::Array::New(Env, Items.size());
+    for (uint32_t I = 0; I < Items.size(); I++) {
+      Napi::Value Item;
+      if (!Items[I].restore(Env, Item)) {
+        return false;
+      }
+      Array.Set(I, Item);
+    }
+    Out = Array;
+    return true;
+  }
+  case Kind::MsgPack:
+    return decodeMsgPack(Env, reinterpret_cast<const uint8_t *>(Bytes.data()),
+                         Bytes.size(), Out);
+  }
+  return false;
+}
+
+size_t MemoValue::size() const noexcept {
+  size_t Size = sizeof(MemoValue) + Bytes.size();
+  for (const MemoValue &Item : Items) {
+    Size += Item.size();
+  }
+  return Size;
+}
+
+bool appendMemoKey(Napi::Env Env, const Napi::Value &Value, std::string &Key) {
+  if (Value.IsUndefined()) {
+    Key.push_back('v');
+  } else if (Value.IsNull()) {
+    Key.push_back('z');
+  } else if (Value.IsBoolean()) {
+    Key.push_back(Value.As<Napi::Boolean>().Value() ? 't' : 'f');
+  } else if (Value.IsNumber()) {
+    Key.push_back('n');
+    appendRaw(Key, Value.As<Napi::Number>().DoubleValue());
+  } else if (Value.IsBigInt()) {
+    bool Lossless = false;
+    int64_t Int = Value.As<Napi::BigInt>().Int64Value(&Lossless);
+    if (Lossless) {
+      Key.push_back('i');
+      appendRaw(Key, Int);
+    } else {
+      uint64_t UInt = Value.As<Napi::BigInt>().Uint64Value(&Lossless);
+      if (!Lossless) {
+        return false;
+      }
+      Key.push_back('u');
+      appendRaw(Key, UInt);
+    }
+  } else if (Value.IsString()) {
+    std::string Str = Value.As<Napi::String>().Utf8Value();
+    appendBytes(Key, 's', Str.data(), Str.size());
+  } else if (Value.IsTypedArray() &&
+             Value.As<Napi::TypedArray>().TypedArrayType() ==
+                 napi_uint8_array) {
+    Napi::Uint8Array Array = Value.As<Napi::Uint8Array>();
+    appendBytes(Key, 'a', Array.Data(), Array.ByteLength());
+  } else if (FileArgument::is(Value)) {
+    return false;
+  } else {
+    /// Objects of RunValue
+    std::vector<uint8_t> Encoded;
+    if (!encodeMsgPack(Env, Value, Encoded)) {
+      return false;
+    }
+    appendBytes(Key, 'm', Encoded.data(), Encoded.size());
+  }
+  return true;
+}
+
+void MemoCache::configure(const std::vector<std::string> &Functions,
+                          uint32_t Capacity, uint64_t MaxBytes) {
+  Pure = std::unordered_set<std::string>(Functions.begin(), Functions.end());
+  this->Capacity = Capacity;
+  this->MaxBytes = MaxBytes;
+}
+
+const MemoValue *MemoCache::lookup(const std::string &Key) {
+  auto It = Index.find(Key);
+  if (It == Index.end()) {
+    Misses++;
+    return nullptr;
+  }
+  Hits++;
+  Entries.splice(Entries.begin(), Entries, It->second);
+  return &It->second->second;
+}
+
+void MemoCache::erase(const std::string &Key) {
+  auto It = Index.find(Key);
+  if (It == Index.end()) {
+    return;
+  }
+  auto EntryIt = It->second;
+  Bytes -= entrySize(*EntryIt);
+  Index.erase(It);
+  Entries.erase(EntryIt);
+  Hits--;
+  Misses++;
+}
+
+void MemoCache::insert(std::string Key, MemoValue &&Value) {
+  Entries.emplace_front(std::move(Key), std::move(Value));
+  const size_t Size = entrySize(Entries.front());
+  if (Size > MaxBytes) {
+    Entries.pop_front();
+    return;
+  }
+  if (!Index.try_emplace(Entries.front().first, Entries.begin()).second) {
+    /// A call with the same key finished first, e.g. from a host function.
+    Entries.pop_front();
+    return;
+  }
+  Bytes += Size;
+  evict();
+}
+
+size_t MemoCache::entrySize(const Entry &E) noexcept {
+  return E.first.size() + E.second.size();
+}
+
+void MemoCache::evict() {
+  while (Entries.size() > Capacity || Bytes > MaxBytes) {
+    const Entry &Last = Entries.back();
+    Bytes -= entrySize(Last);
+    Index.erase(Last.first);
+    Entries.pop_back();
+    Evictions++;
+  }
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
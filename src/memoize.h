@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <napi.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// A result of a Run method held natively. A new JS value is created for
+/// every hit, so callers cannot modify the cached result.
+class MemoValue {
+public:
+  /// Returns false for values which cannot be kept.
+  bool capture(Napi::Env Env, const Napi::Value &Value);
+  /// Returns false if the value can not be recreated.
+  bool restore(Napi::Env Env, Napi::Value &Out) const;
+  /// Approximate native size in bytes.
+  size_t size() const noexcept;
+
+private:
+  enum class Kind {
+    Undefined,
+    Null,
+    Boolean,
+    Number,
+    BigInt,
+    BigUInt,
+    String,
+    Bytes,
+    Array,
+    MsgPack
+  };
+  Kind Type = Kind::Undefined;
+  union {
+    bool Bool;
+    double Number;
+    int64_t Int;
+    uint64_t UInt;
+  } Scalar = {};
+  /// String, Bytes and MsgPack contents
+  std::string Bytes;
+  std::vector<MemoValue> Items;
+};
+
+/// Append an argument of a call to the memoization key. Returns false for
+/// arguments whose value the key cannot capture, e.g. file arguments whose
+/// contents may change.
+bool appendMemoKey(Napi::Env Env, const Napi::Value &Value, std::string &Key);
+
+/// Bounded LRU cache of the results of exports marked pure with the
+/// `PureFunctions` option, keyed by the Run method, the export name and the
+/// marshalled arguments. Keys are compared in full, so a hash collision
+/// never returns the result of another call.
+class MemoCache {
+public:
+  void configure(const std::vector<std::string> &Functions, uint32_t Capacity,
+                 uint64_t MaxBytes);
+  bool isPure(const std::string &FuncName) const {
+    return Pure.count(FuncName) > 0;
+  }
+
+  /// Returns nullptr on a miss.
+  const MemoValue *lookup(const std::string &Key);
+  void insert(std::string Key, MemoValue &&Value);
+  /// Drop an entry found by lookup() which could not be restored, and count
+  /// the lookup as a miss.
+  void erase(const std::string &Key);
+
+  bool isEnabled() const noexcept { return !Pure.empty() && Capacity > 0; }
+  uint64_t getHits() const noexcept { return Hits; }
+  uint64_t getMisses() const noexcept { return Misses; }
+  uint64_t getEvictions() const noexcept { return Evictions; }
+  size_t getEntries() const noexcept { return Entries.size(); }
+  uint64_t getBytes() const noexcept { return Bytes; }
+
+private:
+  using Entry = std::pair<std::string, MemoValue>;
+  static size_t entrySize(const Entry &E) noexcept;
+  void evict();
+
+  std::unordered_set<std::string> Pure;
+  uint32_t Capacity = 0;
+  uint64_t MaxBytes = 0;
+  /// Most recently used first
+  std::list<Entry> Entries;
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> Index;
+  uint64_t Bytes = 0;
+  uint64_t Hits = 0;
+  uint64_t Misses = 0;
+  uint64_t Evictions = 0;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Memory counters summed over all VM instances of the process, including
+/// instances living in other worker threads.
+struct ProcessMemoryStatistics {
+  std::atomic<uint64_t> Instances{0};
+  std::atomic<uint64_t> LinearMemoryPages{0};
+  std::atomic<uint64_t> PeakLinearMemoryPages{0};
+  std::atomic<uint64_t> BytesCopiedIn{0};
+  std::atomic<uint64_t> BytesCopiedOut{0};
+  std::atomic<uint64_t> NativeBytes{0};
+};
+
+inline ProcessMemoryStatistics &processMemoryStatistics() {
+  static ProcessMemoryStatistics Stat;
+  return Stat;
+}
+
+/// Memory counters of one VM instance. Every update is also applied to the
+/// process-level totals.
+class MemoryStatistics {
+private:
+  uint32_t LinearMemoryPages = 0;
+  uint32_t PeakLinearMemoryPages = 0;
+  uint64_t LastCopiedIn = 0;
+  uint64_t LastCopiedOut = 0;
+  uint64_t TotalCopiedIn = 0;
+  uint64_t TotalCopiedOut = 0;
+  uint64_t NativeBytes = 0;
+
+public:
+  MemoryStatistics() { processMemoryStatistics().Instances++; }
+  ~MemoryStatistics() {
+    ProcessMemoryStatistics &Process = processMemoryStatistics();
+    Process.Instances--;
+    Process.LinearMemoryPages -= LinearMemoryPages;
+    Process.NativeBytes -= NativeBytes;
+  }
+  MemoryStatistics(const MemoryStatistics &) = delete;
+  MemoryStatistics &operator=(const MemoryStatistics &) = delete;
+
+  /// Reset the per-call counters.
+  void beginCall() noexcept {
+    LastCopiedIn = 0;
+    LastCopiedOut = 0;
+  }
+  void addCopiedIn(uint64_t Size) noexcept {
+    LastCopiedIn += Size;
+    TotalCopiedIn += Size;
+    processMemoryStatistics().BytesCopiedIn += Size;
+  }
+  void addCopiedOut(uint64_t Size) noexcept {
+    LastCopiedOut += Size;
+    TotalCopiedOut += Size;
+    processMemoryStatistics().BytesCopiedOut += Size;
+  }
+  /// Record the linear memory size at the end of a call.
+  void setLinearMemoryPages(uint32_t Pages) noexcept {
+    ProcessMemoryStatistics &Process = processMemoryStatistics();
+    /// Apply the change in one step, the process peak is the largest total
+    /// seen by any instance, not the largest single instance.
+    const uint64_t Delta = uint64_t(Pages) - uint64_t(LinearMemoryPages);
+    const uint64_t Total = Process.LinearMemoryPages.fetch_add(Delta) + Delta;
+    LinearMemoryPages = Pages;
+    PeakLinearMemoryPages = std::max(PeakLinearMemoryPages, Pages);
+    uint64_t Peak = Process.PeakLinearMemoryPages;
+    while (Peak < Total &&
+           !Process.PeakLinearMemoryPages.compare_exchange_weak(Peak, Total)) {
+    }
+  }
+  /// Record the size of the native buffers held by the instance.
+  void setNativeBytes(uint64_t Size) noexcept {
+    ProcessMemoryStatistics &Process = processMemoryStatistics();
+    Process.NativeBytes += Size;
+    Process.NativeBytes -= NativeBytes;
+    NativeBytes = Size;
+  }
+
+  uint32_t getLinearMemoryPages() const noexcept { return LinearMemoryPages; }
+  uint32_t getPeakLinearMemoryPages() const noexcept {
+    return PeakLinearMemoryPages;
+  }
+  uint64_t getLastCopiedIn() const noexcept { return LastCopiedIn; }
+  uint64_t getLastCopiedOut() const noexcept { return LastCopiedOut; }
+  uint64_t getTotalCopiedIn() const noexcept { return TotalCopiedIn; }
+  uint64_t getTotalCopiedOut() const noexcept { return TotalCopiedOut; }
+  uint64_t getNativeBytes() const noexcept { return NativeBytes; }
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,153 @@
+#include "modulestream.h"
+#include "bytecode.h"
+#include "cache.h"
+#include "errors.h"
+#include "options.h"
+
+namespace WASMEDGE {
+namespace NAPI {
+
+class ModuleStreamWorker : public Napi::AsyncWorker {
+public:
+  ModuleStreamWorker(Napi::Env Env, ModuleStream &Stream,
+                     const Napi::Object &Self)
+      : Napi::AsyncWorker(Env), Deferred(Napi::Promise::Deferred::New(Env)),
+        Stream(Stream), Self(Napi::Persistent(Self)) {}
+
+  Napi::Promise getPromise() const { return Deferred.Promise(); }
+
+protected:
+  void Execute() override { Stream.load(); }
+
+  void OnOK() override {
+    Napi::Env Env = this->Env();
+    Stream.State = ModuleStream::StreamState::Ready;
+    Napi::Object Result = Napi::Object::New(Env);
+    Result.Set("size",
+               Napi::Number::New(Env, static_cast<double>(Stream.Data.size())));
+    Result.Set("cached", Napi::Boolean::New(Env, !Stream.CachePath.empty()));
+    Deferred.Resolve(Result);
+  }
+
+  void OnError(const Napi::Error &Err) override {
+    Deferred.Reject(Err.Value());
+  }
+
+private:
+  Napi::Promise::Deferred Deferred;
+  ModuleStream &Stream;
+  /// Keeps the stream alive while it is loaded.
+  Napi::ObjectReference Self;
+};
+
+Napi::Function ModuleStream::Init(Napi::Env Env) {
+  return DefineClass(Env, "ModuleStream",
+                     {InstanceMethod("write", &ModuleStream::Write),
+                      InstanceMethod("end", &ModuleStream::End)});
+}
+
+ModuleStream::ModuleStream(const Napi::CallbackInfo &Info)
+    : Napi::ObjectWrap<ModuleStream>(Info) {
+  if (Info.Length() > 0 && Info[0].IsObject()) {
+    Napi::Object Options = Info[0].As<Napi::Object>();
+    if (!parseCompilerOptions(Options, Opts)) {
+      napi_throw_error(Info.Env(), "Error",
+                       ErrorMsgs.at(ErrorType::ParseOptionsFailed).c_str());
+      return;
+    }
+    /// The settings which select the cache entry, as parsed by the VM.
+    auto IsTrue = [&Options](const std::string &Key) {
+      return Options.Has(Key) && Options.Get(Key).IsBoolean() &&
+             Options.Get(Key).As<Napi::Boolean>().Value();
+    };
+    AOTMode = IsTrue(kEnableAOTString);
+    Opts.Measure = IsTrue(kEnableMeasurementString);
+  }
+}
+
+void ModuleStream::Write(const Napi::CallbackInfo &Info) {
+  if (State != StreamState::Receiving) {
+    napi_throw_error(Info.Env(), "Error",
+                     ErrorMsgs.at(ErrorType::ModuleStreamEnded).c_str());
+    return;
+  }
+  if (Info.Length() < 1 || !Info[0].IsTypedArray() ||
+      Info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array) {
+    napi_throw_error(Info.Env(), "Error",
+                     ErrorMsgs.at(ErrorType::InvalidInputFormat).c_str());
+    return;
+  }
+  Napi::Uint8Array Chunk = Info[0].As<Napi::Uint8Array>();
+  const uint8_t *Begin = Chunk.Data();
+  const uint8_t *End = Begin + Chunk.ByteLength();
+  const size_t Before = Data.size();
+  Data.insert(Data.end(), Begin, End);
+  /// The same digest as Cache::hash() over the whole bytecode.
+  Hasher.update(Begin, Chunk.ByteLength());
+
+  if (Before < 4 && Data.size() >= 4) {
+    Bytecode Magic;
+    Magic.setData(std::vector<uint8_t>(Data.begin(), Data.begin() + 4));
+    if (!Magic.isValidData()) {
+      State = StreamState::Taken;
+      napi_throw_error(Info.Env(), "Error",
+                       ErrorMsgs.at(ErrorType::UnknownBytecodeFormat).c_str());
+    }
+  }
+}
+
+Napi::Value ModuleStream::End(const Napi::CallbackInfo &Info) {
+  Napi::Env Env = Info.Env();
+  if (State != StreamState::Receiving) {
+    napi_throw_error(Env, "Error",
+                     ErrorMsgs.at(ErrorType::ModuleStreamEnded).c_str());
+    return Napi::Value();
+  }
+  if (Data.size() < 4) {
+    napi_throw_error(Env, "Error",
+                     ErrorMsgs.at(ErrorType::UnknownBytecodeFormat).c_str());
+    return Napi::Value();
+  }
+  State = StreamState::Loading;
+  Hash = Hasher.finish();
+  auto *Worker = new ModuleStreamWorker(Env, *this, Info.This().ToObject());
+  Worker->Queue();
+  return Worker->getPromise();
+}
+
+void ModuleStream::load() {
+  Bytecode Magic;
+  Magic.setData(std::vector<uint8_t>(Data.begin(), Data.begin() + 4));
+  if (Magic.isCompiled()) {
+    /// Native code is written out and loaded by the VM.
+    return;
+  }
+  auto &Registry = ModuleRegistry::instance();
+  if (AOTMode) {
+    Cache Entry;
+    Entry.init(Hash, Opts);
+    if (Entry.isCached()) {
+      Module = Registry.loadFile(Entry.getPath());
+      if (Module) {
+        CachePath = Entry.getPath();
+        return;
+      }
+    }
+    /// Not compiled yet, the VM compiles it on the first call.
+    return;
+  }
+  Module = Registry.loadBuffer(Data);
+}
+
+std::vector<uint8_t> ModuleStream::takeData() {
+  State = StreamState::Taken;
+  return std::move(Data);
+}
+
+std::shared_ptr<const SharedModule> ModuleStream::takeModule() {
+  State = StreamState::Taken;
+  return std::move(Module);
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "compiler.h"
+#include "registry.h"
+#include "sha256.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <napi.h>
+#include <string>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Bytecode received in chunks, e.g. from a network or object storage
+/// stream, for `VM.fromStream`.
+///
+/// Chunks are copied into native memory and hashed as they arrive, and the
+/// magic is checked with the first bytes so a wrong download is rejected
+/// early. When the stream ends, the AoT cache is checked with the finished
+/// hash and the module is parsed (or its artifact loaded) on the thread
+/// pool. A VM constructed from the stream takes over the bytecode and the
+/// parsed module without copying or hashing them again.
+class ModuleStream : public Napi::ObjectWrap<ModuleStream> {
+public:
+  static Napi::Function Init(Napi::Env Env);
+  /// JS: new ModuleStream(options), with the options of the VM
+  ModuleStream(const Napi::CallbackInfo &Info);
+
+  /// end() finished and the contents were not taken yet.
+  bool isReady() const noexcept { return State == StreamState::Ready; }
+  /// The AoT artifact of the bytecode, empty if it is not cached.
+  const std::string &getCachePath() const noexcept { return CachePath; }
+  const Sha256::Digest &getHash() const noexcept { return Hash; }
+  const CompilerOptions &getCompilerOptions() const noexcept { return Opts; }
+  /// Hand the bytecode and the parsed module to a VM.
+  std::vector<uint8_t> takeData();
+  std::shared_ptr<const SharedModule> takeModule();
+
+private:
+  friend class ModuleStreamWorker;
+  enum class StreamState { Receiving, Loading, Ready, Taken };
+
+  /// JS: write(chunk: Uint8Array)
+  void Write(const Napi::CallbackInfo &Info);
+  /// JS: end() -> Promise<{size, cached}>
+  Napi::Value End(const Napi::CallbackInfo &Info);
+  /// Runs on the thread pool.
+  void load();
+
+  StreamState State = StreamState::Receiving;
+  std::vector<uint8_t> Data;
+  /// Hashes the chunks as they arrive; `Hash` is set by end().
+  Sha256 Hasher;
+  Sha256::Digest Hash = {};
+  CompilerOptions Opts;
+  bool AOTMode = false;
+  std::string CachePath;
+  std::shared_ptr<const SharedModule> Module;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
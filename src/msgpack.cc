@@ -0,0 +1,409 @@
+#include "msgpack.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+constexpr uint32_t kMaxDepth = 256;
+/// Number.MAX_SAFE_INTEGER
+constexpr double kMaxSafeInteger = 9007199254740991.0;
+
+void putBigEndian(std::vector<uint8_t> &Out, uint64_t V, uint32_t Bytes) {
+  for (uint32_t I = Bytes; I > 0; I--) {
+    Out.push_back(static_cast<uint8_t>(V >> ((I - 1) * 8)));
+  }
+}
+
+void putUInt(std::vector<uint8_t> &Out, uint64_t V) {
+  if (V <= 0x7f) {
+    Out.push_back(static_cast<uint8_t>(V));
+  } else if (V <= std::numeric_limits<uint8_t>::max()) {
+    Out.push_back(0xcc);
+    putBigEndian(Out, V, 1);
+  } else if (V <= std::numeric_limits<uint16_t>::max()) {
+    Out.push_back(0xcd);
+    putBigEndian(Out, V, 2);
+  } else if (V <= std::numeric_limits<uint32_t>::max()) {
+    Out.push_back(0xce);
+    putBigEndian(Out, V, 4);
+  } else {
+    Out.push_back(0xcf);
+    putBigEndian(Out, V, 8);
+  }
+}
+
+void putInt(std::vector<uint8_t> &Out, int64_t V) {
+  if (V >= 0) {
+    putUInt(Out, static_cast<uint64_t>(V));
+  } else if (V >= -32) {
+    Out.push_back(static_cast<uint8_t>(V));
+  } else if (V >= std::numeric_limits<int8_t>::min()) {
+    Out.push_back(0xd0);
+    putBigEndian(Out, static_cast<uint64_t>(V), 1);
+  } else if (V >= std::numeric_limits<int16_t>::min()) {
+    Out.push_back(0xd1);
+    putBigEndian(Out, static_cast<uint64_t>(V), 2);
+  } else if (V >= std::numeric_limits<int32_t>::min()) {
+    Out.push_back(0xd2);
+    putBigEndian(Out, static_cast<uint64_t>(V), 4);
+  } else {
+    Out.push_back(0xd3);
+    putBigEndian(Out, static_cast<uint64_t>(V), 8);
+  }
+}
+
+void putDouble(std::vector<uint8_t> &Out, double D) {
+  uint64_t Bits;
+  std::memcpy(&Bits, &D, sizeof(Bits));
+  Out.push_back(0xcb);
+  putBigEndian(Out, Bits, 8);
+}
+
+/// Header of str, bin, array and map. `Fix` and `FixMax` describe the
+/// fix-size form, `Fix` and `Op8` are 0 if there is no such form.
+void putHeader(std::vector<uint8_t> &Out, size_t Len, uint8_t Fix,
+               size_t FixMax, uint8_t Op8, uint8_t Op16, uint8_t Op32) {
+  if (Fix != 0 && Len <= FixMax) {
+    Out.push_back(static_cast<uint8_t>(Fix | Len));
+  } else if (Op8 != 0 && Len <= std::numeric_limits<uint8_t>::max()) {
+    Out.push_back(Op8);
+    putBigEndian(Out, Len, 1);
+  } else if (Len <= std::numeric_limits<uint16_t>::max()) {
+    Out.push_back(Op16);
+    putBigEndian(Out, Len, 2);
+  } else {
+    Out.push_back(Op32);
+    putBigEndian(Out, Len, 4);
+  }
+}
+
+void putBinary(std::vector<uint8_t> &Out, const uint8_t *Data, size_t Len) {
+  putHeader(Out, Len, 0, 0, 0xc4, 0xc5, 0xc6);
+  Out.insert(Out.end(), Data, Data + Len);
+}
+
+bool encodeString(napi_env Env, napi_value Value, std::vector<uint8_t> &Out) {
+  size_t Len = 0;
+  if (napi_get_value_string_utf8(Env, Value, nullptr, 0, &Len) != napi_ok) {
+    return false;
+  }
+  putHeader(Out, Len, 0xa0, 31, 0xd9, 0xda, 0xdb);
+  /// Let V8 write the UTF-8 bytes in place, plus its null terminator.
+  const size_t Pos = Out.size();
+  Out.resize(Pos + Len + 1);
+  size_t Written = 0;
+  napi_get_value_string_utf8(Env, Value, reinterpret_cast<char *>(&Out[Pos]),
+                             Len + 1, &Written);
+  Out.resize(Pos + Written);
+  return Written == Len;
+}
+
+bool encodeValue(Napi::Env Env, const Napi::Value &Value,
+                 std::vector<uint8_t> &Out, uint32_t Depth) {
+  if (Depth > kMaxDepth) {
+    return false;
+  }
+  switch (Value.Type()) {
+  case napi_undefined:
+  case napi_null:
+    Out.push_back(0xc0);
+    return true;
+  case napi_boolean:
+    Out.push_back(Value.As<Napi::Boolean>().Value() ? 0xc3 : 0xc2);
+    return true;
+  case napi_number: {
+    double D = Value.As<Napi::Number>().DoubleValue();
+    if (std::trunc(D) == D && std::fabs(D) <= kMaxSafeInteger) {
+      putInt(Out, static_cast<int64_t>(D));
+    } else {
+      putDouble(Out, D);
+    }
+    return true;
+  }
+  case napi_bigint: {
+    bool Lossless = false;
+    int64_t I = Value.As<Napi::BigInt>().Int64Value(&Lossless);
+    if (Lossless) {
+      putInt(Out, I);
+      return true;
+    }
+    uint64_t U = Value.As<Napi::BigInt>().Uint64Value(&Lossless);
+    if (Lossless) {
+      putUInt(Out, U);
+      return true;
+    }
+    return false;
+  }
+  case napi_string:
+    return encodeString(Env, Value, Out);
+  case napi_object:
+    break;
+  default:
+    /// Functions, symbols and externals have no data representation.
+    return false;
+  }
+
+  if (Value.IsTypedArray()) {
+    if (Value.As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array) {
+      return false;
+    }
+    Napi::Uint8Array Array = Value.As<Napi::Uint8Array>();
+    putBinary(Out, Array.Data(), Array.ByteLength());
+    return true;
+  }
+  if (Value.IsArrayBuffer()) {
+    Napi::ArrayBuffer Buffer = Value.As<Napi::ArrayBuffer>();
+    putBinary(Out, static_cast<const uint8_t *>(Buffer.Data()),
+              Buffer.ByteLength());
+    return true;
+  }
+  if (Value.IsArray()) {
+    Napi::Array Array = Value.As<Napi::Array>();
+    const uint32_t Len = Array.Length();
+    putHeader(Out, Len, 0x90, 15, 0, 0xdc, 0xdd);
+    for (uint32_t I = 0; I < Len; I++) {
+      if (!encodeValue(Env, Array.Get(I), Out, Depth + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Napi::Object Object = Value.As<Napi::Object>();
+  /// Only own enumerable properties, GetPropertyNames() would also list
+  /// inherited ones.
+  napi_value KeysValue;
+  if (napi_get_all_property_names(
+          Env, Object, napi_key_own_only,
+          static_cast<napi_key_filter>(napi_key_enumerable |
+                                       napi_key_skip_symbols),
+          napi_key_numbers_to_strings, &KeysValue) != napi_ok) {
+    return false;
+  }
+  Napi::Array Keys(Env, KeysValue);
+  const uint32_t Len = Keys.Length();
+  putHeader(Out, Len, 0x80, 15, 0, 0xde, 0xdf);
+  for (uint32_t I = 0; I < Len; I++) {
+    Napi::Value Key = Keys.Get(I);
+    if (!encodeValue(Env, Key, Out, Depth + 1) ||
+        !encodeValue(Env, Object.Get(Key), Out, Depth + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class Decoder {
+public:
+  Decoder(Napi::Env Env, const uint8_t *Data, size_t Size)
+      : Env(Env), Data(Data), Size(Size) {}
+
+  bool done() const noexcept { return Pos == Size; }
+
+  bool decode(Napi::Value &Out, uint32_t Depth) {
+    uint8_t Op;
+    if (Depth > kMaxDepth || !readByte(Op)) {
+      return false;
+    }
+    if (Op <= 0x7f) {
+      Out = Napi::Number::New(Env, Op);
+      return true;
+    }
+    if (Op >= 0xe0) {
+      Out = Napi::Number::New(Env, static_cast<int8_t>(Op));
+      return true;
+    }
+    if (Op >= 0x80 && Op <= 0x8f) {
+      return decodeMap(Op & 0x0f, Out, Depth);
+    }
+    if (Op >= 0x90 && Op <= 0x9f) {
+      return decodeArray(Op & 0x0f, Out, Depth);
+    }
+    if (Op >= 0xa0 && Op <= 0xbf) {
+      return decodeString(Op & 0x1f, Out);
+    }
+
+    uint64_t V = 0;
+    switch (Op) {
+    case 0xc0:
+      Out = Env.Null();
+      return true;
+    case 0xc2:
+    case 0xc3:
+      Out = Napi::Boolean::New(Env, Op == 0xc3);
+      return true;
+    case 0xc4:
+    case 0xc5:
+    case 0xc6:
+      return readBigEndian(1u << (Op - 0xc4), V) && decodeBinary(V, Out);
+    case 0xca: {
+      float F;
+      uint32_t Bits;
+      if (!readBigEndian(4, V)) {
+        return false;
+      }
+      Bits = static_cast<uint32_t>(V);
+      std::memcpy(&F, &Bits, sizeof(F));
+      Out = Napi::Number::New(Env, F);
+      return true;
+    }
+    case 0xcb: {
+      double D;
+      if (!readBigEndian(8, V)) {
+        return false;
+      }
+      std::memcpy(&D, &V, sizeof(D));
+      Out = Napi::Number::New(Env, D);
+      return true;
+    }
+    case 0xcc:
+    case 0xcd:
+    case 0xce:
+    case 0xcf:
+      if (!readBigEndian(1u << (Op - 0xcc), V)) {
+        return false;
+      }
+      Out = V <= static_cast<uint64_t>(kMaxSafeInteger)
+                ? Napi::Value(Napi::Number::New(Env, static_cast<double>(V)))
+                : Napi::Value(Napi::BigInt::New(Env, V));
+      return true;
+    case 0xd0:
+    case 0xd1:
+    case 0xd2:
+    case 0xd3: {
+      const uint32_t Bytes = 1u << (Op - 0xd0);
+      if (!readBigEndian(Bytes, V)) {
+        return false;
+      }
+      /// Sign extend.
+      const uint32_t Shift = 64 - Bytes * 8;
+      const int64_t I = static_cast<int64_t>(V << Shift) >> Shift;
+      Out = std::fabs(static_cast<double>(I)) <= kMaxSafeInteger
+                ? Napi::Value(Napi::Number::New(Env, static_cast<double>(I)))
+                : Napi::Value(Napi::BigInt::New(Env, I));
+      return true;
+    }
+    case 0xd9:
+    case 0xda:
+    case 0xdb:
+      return readBigEndian(1u << (Op - 0xd9), V) && decodeString(V, Out);
+    case 0xdc:
+    case 0xdd:
+      return readBigEndian(Op == 0xdc ? 2 : 4, V) && decodeArray(V, Out, Depth);
+    case 0xde:
+    case 0xdf:
+      return readBigEndian(Op == 0xde ? 2 : 4, V) && decodeMap(V, Out, Depth);
+    default:
+      /// 0xc1 is unused, the rest are extension types.
+      return false;
+    }
+  }
+
+private:
+  bool readByte(uint8_t &B) {
+    if (Pos >= Size) {
+      return false;
+    }
+    B = Data[Pos++];
+    return true;
+  }
+
+  bool readBigEndian(uint32_t Bytes, uint64_t &V) {
+    if (Size - Pos < Bytes) {
+      return false;
+    }
+    V = 0;
+    for (uint32_t I = 0; I < Bytes; I++) {
+      V = (V << 8) | Data[Pos++];
+    }
+    return true;
+  }
+
+  bool decodeString(uint64_t Len, Napi::Value &Out) {
+    if (Size - Pos < Len) {
+      return false;
+    }
+    Out = Napi::String::New(Env, reinterpret_cast<const char *>(Data + Pos),
+                            Len);
+    Pos += Len;
+    return true;
+  }
+
+  bool decodeBinary(uint64_t Len, Napi::Value &Out) {
+    if (Size - Pos < Len) {
+      return false;
+    }
+    Napi::ArrayBuffer Buffer = Napi::ArrayBuffer::New(Env, Len);
+    std::memcpy(Buffer.Data(), Data + Pos, Len);
+    Out = Napi::Uint8Array::New(Env, Len, Buffer, 0);
+    Pos += Len;
+    return true;
+  }
+
+  bool decodeArray(uint64_t Len, Napi::Value &Out, uint32_t Depth) {
+    /// Every element takes at least one byte.
+    if (Size - Pos < Len) {
+      return false;
+    }
+    Napi::Array Array = Napi::Array::New(Env, Len);
+    for (uint32_t I = 0; I < Len; I++) {
+      Napi::Value Element;
+      if (!decode(Element, Depth + 1)) {
+        return false;
+      }
+      Array.Set(I, Element);
+    }
+    Out = Array;
+    return true;
+  }
+
+  bool decodeMap(uint64_t Len, Napi::Value &Out, uint32_t Depth) {
+    if ((Size - Pos) / 2 < Len) {
+      return false;
+    }
+    Napi::Object Object = Napi::Object::New(Env);
+    for (uint32_t I = 0; I < Len; I++) {
+      Napi::Value Key, Value;
+      if (!decode(Key, Depth + 1) || !decode(Value, Depth + 1)) {
+        return false;
+      }
+      /// Define own properties, a `__proto__` key must not replace the
+      /// prototype as an assignment would.
+      napi_property_descriptor Desc = {};
+      Desc.name = Key.IsString() ? Key : Key.ToString();
+      Desc.value = Value;
+      Desc.attributes = napi_default_jsproperty;
+      if (napi_define_properties(Env, Object, 1, &Desc) != napi_ok) {
+        return false;
+      }
+    }
+    Out = Object;
+    return true;
+  }
+
+  Napi::Env Env;
+  const uint8_t *Data;
+  size_t Size;
+  size_t Pos = 0;
+};
+
+} // namespace
+
+bool encodeMsgPack(Napi::Env Env, const Napi::Value &Value,
+                   std::vector<uint8_t> &Out) {
+  return encodeValue(Env, Value, Out, 0);
+}
+
+bool decodeMsgPack(Napi::Env Env, const uint8_t *Data, size_t Size,
+                   Napi::Value &Value) {
+  Decoder D(Env, Data, Size);
+  return D.decode(Value, 0) && D.done();
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <napi.h>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// MessagePack encoding of JS values, used to pass structured data to the
+/// guest without going through JSON strings.
+///
+/// Numbers with an integral value are encoded as the smallest integer type,
+/// other numbers as float 64. BigInts become int 64 or uint 64, Uint8Arrays
+/// and ArrayBuffers become bin, and `undefined` becomes nil. Strings are
+/// written as UTF-8 directly into `Out`.
+///
+/// Returns false for values which cannot be encoded (functions, symbols,
+/// BigInts wider than 64 bits, nesting deeper than 256 levels).
+bool encodeMsgPack(Napi::Env Env, const Napi::Value &Value,
+                   std::vector<uint8_t> &Out);
+
+/// Decode one MessagePack value from `Data` into a JS value. Integers outside
+/// the safe integer range of Number are returned as BigInt. Returns false on
+/// malformed or truncated input and on extension types.
+bool decodeMsgPack(Napi::Env Env, const uint8_t *Data, size_t Size,
+                   Napi::Value &Value);
+
+} // namespace NAPI
+} // namespace WASMEDGE
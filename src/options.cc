@@ -92,6 +92,76 @@ bool parseDirs(std::vector<std::string> &Dirs, const Napi::Object &Options) {
   return true;
 }
 
+/// Build a memfs layer from an object which maps relative file paths to
+/// strings or Uint8Arrays. Buffers are written straight from JS memory.
+std::shared_ptr<MemFSLayer> parseMemFSFiles(const Napi::Value &Value,
+                                            bool Preopened) {
+  if (!Value.IsObject()) {
+    return nullptr;
+  }
+  Napi::Object Object = Value.As<Napi::Object>();
+  Napi::Array Keys = Object.GetPropertyNames();
+  std::vector<MemFSFile> Files;
+  std::vector<std::string> Strings(Keys.Length());
+  for (uint32_t i = 0; i < Keys.Length(); i++) {
+    Napi::Value Key = Keys[i];
+    Napi::Value Content = Object.Get(Key);
+    MemFSFile File;
+    File.Path = Key.As<Napi::String>().Utf8Value();
+    if (Content.IsString()) {
+      Strings[i] = Content.As<Napi::String>().Utf8Value();
+      File.Data = reinterpret_cast<const uint8_t *>(Strings[i].data());
+      File.Size = Strings[i].size();
+    } else if (Content.IsTypedArray() &&
+               Content.As<Napi::TypedArray>().TypedArrayType() ==
+                   napi_uint8_array) {
+      Napi::Uint8Array Array = Content.As<Napi::Uint8Array>();
+      File.Data = Array.Data();
+      File.Size = Array.ByteLength();
+    } else {
+      return nullptr;
+    }
+    Files.push_back(std::move(File));
+  }
+  return shareMemFSLayer(Files, Preopened);
+}
+
+bool parseMemFS(
+    std::vector<std::string> &Dirs,
+    std::vector<std::shared_ptr<MemFSLayer>> &Layers,
+    std::vector<std::pair<std::string, std::shared_ptr<MemFSLayer>>> &Writable,
+    const Napi::Object &Options) {
+  Layers.clear();
+  Writable.clear();
+  for (const std::string &OptionKey : {kMemFSString, kMemFSWritableString}) {
+    if (!Options.Has(OptionKey)) {
+      continue;
+    }
+    if (!Options.Get(OptionKey).IsObject()) {
+      return false;
+    }
+    Napi::Object Trees = Options.Get(OptionKey).As<Napi::Object>();
+    Napi::Array Keys = Trees.GetPropertyNames();
+    for (uint32_t i = 0; i < Keys.Length(); i++) {
+      Napi::Value Key = Keys[i];
+      std::string GuestPath = Key.As<Napi::String>().Utf8Value();
+      std::shared_ptr<MemFSLayer> Layer =
+          parseMemFSFiles(Trees.Get(Key), OptionKey == kMemFSString);
+      if (!Layer) {
+        return false;
+      }
+      if (OptionKey == kMemFSString) {
+        // Dir format: <guest_path>:<host_path>
+        Dirs.push_back(GuestPath + ":" + Layer->getPath());
+        Layers.push_back(std::move(Layer));
+      } else {
+        Writable.emplace_back(GuestPath, std::move(Layer));
+      }
+    }
+  }
+  return true;
+}
+
 bool parseEnvs(std::vector<std::string> &Envs, const Napi::Object &Options) {
   Envs.clear();
   if (Options.Has(kEnvString) && Options.Get(kEnvString).IsObject()) {
@@ -133,19 +203,151 @@ bool parseMeasure(const Napi::Object &Options) {
   return false;
 }
 
+bool parseMaxMemoryPages(uint32_t &Pages, const Napi::Object &Options) {
+  Pages = 0;
+  if (Options.Has(kMaxMemoryPagesString)) {
+    Napi::Value Value = Options.Get(kMaxMemoryPagesString);
+    if (!Value.IsNumber()) {
+      return false;
+    }
+    /// A wasm32 linear memory has at most 65536 pages.
+    double Num = Value.As<Napi::Number>().DoubleValue();
+    if (Num < 1 || Num > 65536) {
+      return false;
+    }
+    Pages = Value.As<Napi::Number>().Uint32Value();
+  }
+  return true;
+}
+
+bool parseMemoize(std::vector<std::string> &PureFunctions, uint32_t &Capacity,
+                  uint64_t &MaxBytes, const Napi::Object &Options) {
+  PureFunctions.clear();
+  if (Options.Has(kPureFunctionsString)) {
+    Napi::Value Value = Options.Get(kPureFunctionsString);
+    if (!Value.IsArray()) {
+      return false;
+    }
+    Napi::Array Names = Value.As<Napi::Array>();
+    for (uint32_t I = 0; I < Names.Length(); I++) {
+      Napi::Value Name = Names[I];
+      if (!Name.IsString()) {
+        return false;
+      }
+      PureFunctions.push_back(Name.As<Napi::String>().Utf8Value());
+    }
+  }
+  if (Options.Has(kMemoizeCapacityString)) {
+    Napi::Value Value = Options.Get(kMemoizeCapacityString);
+    if (!Value.IsNumber() || Value.As<Napi::Number>().DoubleValue() < 0) {
+      return false;
+    }
+    Capacity = Value.As<Napi::Number>().Uint32Value();
+  }
+  if (Options.Has(kMemoizeMaxBytesString)) {
+    Napi::Value Value = Options.Get(kMemoizeMaxBytesString);
+    if (!Value.IsNumber() || Value.As<Napi::Number>().DoubleValue() < 0) {
+      return false;
+    }
+    MaxBytes = static_cast<uint64_t>(Value.As<Napi::Number>().DoubleValue());
+  }
+  return true;
+}
+
+bool parseMaxQueueLength(uint32_t &Length, const Napi::Object &Options) {
+  if (Options.Has(kMaxQueueLengthString)) {
+    Napi::Value Value = Options.Get(kMaxQueueLengthString);
+    if (!Value.IsNumber() || Value.As<Napi::Number>().DoubleValue() < 0) {
+      return false;
+    }
+    Length = Value.As<Napi::Number>().Uint32Value();
+  }
+  return true;
+}
+
+bool parseProfile(std::string &Output, uint32_t &Interval,
+                  const Napi::Object &Options) {
+  Output.clear();
+  if (Options.Has(kProfileOutputString)) {
+    Napi::Value Value = Options.Get(kProfileOutputString);
+    if (!Value.IsString()) {
+      return false;
+    }
+    Output = Value.As<Napi::String>().Utf8Value();
+  }
+  if (Options.Has(kProfileIntervalString)) {
+    Napi::Value Value = Options.Get(kProfileIntervalString);
+    if (!Value.IsNumber() || Value.As<Napi::Number>().Uint32Value() == 0) {
+      return false;
+    }
+    Interval = Value.As<Napi::Number>().Uint32Value();
+  }
+  return true;
+}
+
+bool parseBoolean(const Napi::Object &Options, const std::string &Key) {
+  if (Options.Has(Key) && Options.Get(Key).IsBoolean()) {
+    return Options.Get(Key).As<Napi::Boolean>().Value();
+  }
+  return false;
+}
+
 } // namespace
 
+bool parseCompilerOptions(const Napi::Object &Options, CompilerOptions &Opts) {
+  if (Options.Has(kCompilerOptLevelString)) {
+    Napi::Value Level = Options.Get(kCompilerOptLevelString);
+    if (!Level.IsString() ||
+        !parseOptimizationLevel(Level.As<Napi::String>().Utf8Value(),
+                                Opts.OptLevel)) {
+      return false;
+    }
+  }
+  if (Options.Has(kCompilerTargetCPUString)) {
+    Napi::Value Target = Options.Get(kCompilerTargetCPUString);
+    if (!Target.IsString() ||
+        !parseTargetCPU(Target.As<Napi::String>().Utf8Value(),
+                        Opts.GenericBinary)) {
+      return false;
+    }
+  }
+  if (Options.Has(kCompilerOutputFormatString)) {
+    Napi::Value Format = Options.Get(kCompilerOutputFormatString);
+    if (!Format.IsString() ||
+        !parseOutputFormat(Format.As<Napi::String>().Utf8Value(),
+                           Opts.OutputFormat)) {
+      return false;
+    }
+  }
+  Opts.DumpIR = parseBoolean(Options, kCompilerDumpIRString);
+  Opts.Interruptible = parseBoolean(Options, kCompilerInterruptibleString);
+  return true;
+}
+
 bool Options::parse(const Napi::Object &Options) {
   if (!parseCmdArgs(getWasiCmdArgs(), Options) ||
       !parseDirs(getWasiDirs(), Options) ||
+      !parseMemFS(getWasiDirs(), MemFSLayers, MemFSWritable, Options) ||
       !parseEnvs(getWasiEnvs(), Options) ||
-      !parseAllowedCmds(getAllowedCmds(), Options)) {
+      !parseAllowedCmds(getAllowedCmds(), Options) ||
+      !parseCompilerOptions(Options, getCompilerOptions()) ||
+      !parseMaxMemoryPages(MaxMemoryPages, Options) ||
+      !parseMaxQueueLength(MaxQueueLength, Options) ||
+      !parseMemoize(PureFunctions, MemoizeCapacity, MemoizeMaxBytes,
+                    Options) ||
+      !parseProfile(ProfileOutput, ProfileInterval, Options)) {
     return false;
   }
   setReactorMode(!parseWasiStartFlag(Options));
   setAOTMode(parseAOTConfig(Options));
   setMeasure(parseMeasure(Options));
   setAllowedCmdsAll(parseAllowedCmdsAll(Options));
+  setReclaimMemory(parseBoolean(Options, kReclaimMemoryString));
+  setPerfCounters(parseBoolean(Options, kEnablePerfCountersString));
+  setTrustValidated(parseBoolean(Options, kTrustValidatedString));
+  setInterpretWhileCompiling(
+      parseBoolean(Options, kInterpretWhileCompilingString));
+  getCompilerOptions().Measure = isMeasuring();
   return true;
 }
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "compiler.h"
+#include "memfs.h"
+
+#include <memory>
 #include <napi.h>
 #include <string>
 #include <vector>
@@ -12,8 +16,31 @@ static inline std::string kAllowedCommandsAllString [[maybe_unused]] = "AllowAll
 static inline std::string kCmdArgsString [[maybe_unused]] = "args";
 static inline std::string kPreOpensString [[maybe_unused]] = "preopens";
 static inline std::string kEnvString [[maybe_unused]] = "env";
+static inline std::string kMemFSString [[maybe_unused]] = "memfs";
+static inline std::string kMemFSWritableString [[maybe_unused]] = "memfsWritable";
 static inline std::string kEnableAOTString [[maybe_unused]] = "EnableAOT";
 static inline std::string kEnableMeasurementString [[maybe_unused]] = "EnableMeasurement";
+static inline std::string kCompilerOptLevelString [[maybe_unused]] = "CompilerOptimizationLevel";
+static inline std::string kCompilerTargetCPUString [[maybe_unused]] = "CompilerTargetCPU";
+static inline std::string kCompilerOutputFormatString [[maybe_unused]] = "CompilerOutputFormat";
+static inline std::string kCompilerDumpIRString [[maybe_unused]] = "CompilerDumpIR";
+static inline std::string kCompilerInterruptibleString [[maybe_unused]] = "CompilerInterruptible";
+static inline std::string kMaxMemoryPagesString [[maybe_unused]] = "MaxMemoryPages";
+static inline std::string kReclaimMemoryString [[maybe_unused]] = "ReclaimMemory";
+static inline std::string kProfileOutputString [[maybe_unused]] = "ProfileOutput";
+static inline std::string kProfileIntervalString [[maybe_unused]] = "ProfileInterval";
+static inline std::string kEnablePerfCountersString [[maybe_unused]] = "EnablePerfCounters";
+static inline std::string kMaxQueueLengthString [[maybe_unused]] = "MaxQueueLength";
+static inline std::string kTrustValidatedString [[maybe_unused]] = "TrustValidated";
+static inline std::string kImportsString [[maybe_unused]] = "imports";
+static inline std::string kModulesString [[maybe_unused]] = "modules";
+static inline std::string kInterpretWhileCompilingString [[maybe_unused]] = "InterpretWhileCompiling";
+static inline std::string kPureFunctionsString [[maybe_unused]] = "PureFunctions";
+static inline std::string kMemoizeCapacityString [[maybe_unused]] = "MemoizeCapacity";
+static inline std::string kMemoizeMaxBytesString [[maybe_unused]] = "MemoizeMaxBytes";
+
+/// Parse the AOT compiler settings. Returns false on invalid values.
+bool parseCompilerOptions(const Napi::Object &Options, CompilerOptions &Opts);
 
 class Options {
 private:
@@ -21,13 +48,40 @@ private:
   bool AOTMode;
   bool Measure;
   bool AllowedCmdsAll;
+  bool ReclaimMemory = false;
+  bool PerfCounters = false;
+  bool TrustValidated = false;
+  bool InterpretWhileCompiling = false;
+  uint32_t MaxMemoryPages = 0;
+  uint32_t MaxQueueLength = 1024;
+  uint32_t MemoizeCapacity = 1024;
+  uint64_t MemoizeMaxBytes = 16 * 1024 * 1024;
+  std::string ProfileOutput;
+  uint32_t ProfileInterval = 1000;
   std::vector<std::string> WasiCmdArgs, WasiDirs, WasiEnvs, AllowedCmds;
+  std::vector<std::string> PureFunctions;
+  CompilerOptions CompilerOpts;
+  /// Read-only memfs layers, already added to WasiDirs.
+  std::vector<std::shared_ptr<MemFSLayer>> MemFSLayers;
+  /// Guest path and template of the per-call writable memfs trees.
+  std::vector<std::pair<std::string, std::shared_ptr<MemFSLayer>>>
+      MemFSWritable;
 
 public:
   void setReactorMode(bool Value = true) { ReactorMode = Value; }
   void setAOTMode(bool Value = true) { AOTMode = Value; }
   void setMeasure(bool Value = true) { Measure = Value; }
   void setAllowedCmdsAll(bool Value = true) { AllowedCmdsAll = Value; }
+  void setReclaimMemory(bool Value = true) { ReclaimMemory = Value; }
+  void setPerfCounters(bool Value = true) { PerfCounters = Value; }
+  void setTrustValidated(bool Value = true) { TrustValidated = Value; }
+  void setInterpretWhileCompiling(bool Value = true) {
+    InterpretWhileCompiling = Value;
+  }
+  void setMaxMemoryPages(uint32_t Value) { MaxMemoryPages = Value; }
+  void setMaxQueueLength(uint32_t Value) { MaxQueueLength = Value; }
+  void setProfileOutput(const std::string &Path) { ProfileOutput = Path; }
+  void setProfileInterval(uint32_t Value) { ProfileInterval = Value; }
   void setWasiCmdArgs(const std::vector<std::string> &WCA) {
     WasiCmdArgs = WCA;
   }
@@ -40,6 +94,30 @@ public:
   bool isAOTMode() const noexcept { return AOTMode; }
   bool isMeasuring() const noexcept { return Measure; }
   bool isAllowedCmdsAll() const noexcept { return AllowedCmdsAll; }
+  bool isReclaimMemory() const noexcept { return ReclaimMemory; }
+  bool isPerfCounters() const noexcept { return PerfCounters; }
+  /// Skip validation of modules which already passed it.
+  bool isTrustValidated() const noexcept { return TrustValidated; }
+  /// Run in the interpreter instead of waiting for another thread or process
+  /// compiling the module.
+  bool isInterpretWhileCompiling() const noexcept {
+    return InterpretWhileCompiling;
+  }
+  /// 0 means the WasmEdge default (65536 pages, 4 GiB).
+  uint32_t getMaxMemoryPages() const noexcept { return MaxMemoryPages; }
+  /// Number of RunAsync calls which may wait for a busy instance.
+  uint32_t getMaxQueueLength() const noexcept { return MaxQueueLength; }
+  /// Exports whose results are memoized.
+  const std::vector<std::string> &getPureFunctions() const noexcept {
+    return PureFunctions;
+  }
+  /// Bounds of the memoized results, in entries and bytes.
+  uint32_t getMemoizeCapacity() const noexcept { return MemoizeCapacity; }
+  uint64_t getMemoizeMaxBytes() const noexcept { return MemoizeMaxBytes; }
+  /// Empty if profiling is disabled.
+  const std::string &getProfileOutput() const noexcept { return ProfileOutput; }
+  /// Sampling interval in microseconds of CPU time.
+  uint32_t getProfileInterval() const noexcept { return ProfileInterval; }
   const std::vector<std::string> &getWasiCmdArgs() const { return WasiCmdArgs; }
   std::vector<std::string> &getWasiCmdArgs() { return WasiCmdArgs; }
   const std::vector<std::string> &getAllowedCmds() const { return AllowedCmds; }
@@ -48,6 +126,12 @@ public:
   std::vector<std::string> &getWasiDirs() { return WasiDirs; }
   const std::vector<std::string> &getWasiEnvs() const { return WasiEnvs; }
   std::vector<std::string> &getWasiEnvs() { return WasiEnvs; }
+  const std::vector<std::pair<std::string, std::shared_ptr<MemFSLayer>>> &
+  getMemFSWritable() const {
+    return MemFSWritable;
+  }
+  const CompilerOptions &getCompilerOptions() const { return CompilerOpts; }
+  CompilerOptions &getCompilerOptions() { return CompilerOpts; }
   bool parse(const Napi::Object &Options);
 };
 
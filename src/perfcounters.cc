@@ -0,0 +1,129 @@
+#include "perfcounters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+#ifdef __linux__
+constexpr uint64_t kEventConfigs[PerfCounters::kNumEvents] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+int openEvent(uint64_t Config) {
+  struct perf_event_attr Attr;
+  std::memset(&Attr, 0, sizeof(Attr));
+  Attr.size = sizeof(Attr);
+  Attr.type = PERF_TYPE_HARDWARE;
+  Attr.config = Config;
+  Attr.disabled = 1;
+  Attr.exclude_kernel = 1;
+  Attr.exclude_hv = 1;
+  Attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  /// pid 0 and cpu -1: the calling thread on any CPU.
+  return static_cast<int>(
+      syscall(__NR_perf_event_open, &Attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() { Fds.fill(-1); }
+
+PerfCounters::~PerfCounters() { close(); }
+
+void PerfCounters::open() {
+  close();
+#ifdef __linux__
+  Tid = syscall(SYS_gettid);
+  int LastErrno = 0;
+  bool AnyOpened = false;
+  for (uint32_t I = 0; I < kNumEvents; I++) {
+    Fds[I] = openEvent(kEventConfigs[I]);
+    if (Fds[I] < 0) {
+      LastErrno = errno;
+    } else {
+      AnyOpened = true;
+    }
+  }
+  if (!AnyOpened) {
+    Error = std::string("perf_event_open: ") + std::strerror(LastErrno);
+  }
+#else
+  Error = "perf_event_open is only supported on Linux";
+#endif
+}
+
+void PerfCounters::close() {
+#ifdef __linux__
+  for (int &Fd : Fds) {
+    if (Fd >= 0) {
+      ::close(Fd);
+    }
+    Fd = -1;
+  }
+#endif
+  Error.clear();
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+  if (Tid != syscall(SYS_gettid)) {
+    open();
+  }
+  for (int Fd : Fds) {
+    if (Fd >= 0) {
+      ioctl(Fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(Fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+  Running = true;
+#else
+  if (Error.empty()) {
+    open();
+  }
+#endif
+}
+
+void PerfCounters::stop() {
+  if (!Running) {
+    return;
+  }
+  Running = false;
+  Calls++;
+#ifdef __linux__
+  for (uint32_t I = 0; I < kNumEvents; I++) {
+    Last[I] = 0;
+    if (Fds[I] < 0) {
+      continue;
+    }
+    ioctl(Fds[I], PERF_EVENT_IOC_DISABLE, 0);
+    /// value, time_enabled, time_running
+    uint64_t Values[3] = {0, 0, 0};
+    if (read(Fds[I], Values, sizeof(Values)) != sizeof(Values)) {
+      continue;
+    }
+    /// Scale up if the PMU was multiplexed with other events.
+    if (Values[2] != 0 && Values[2] < Values[1]) {
+      Values[0] = static_cast<uint64_t>(static_cast<double>(Values[0]) *
+                                        Values[1] / Values[2]);
+    }
+    Last[I] = Values[0];
+    Total[I] += Values[0];
+  }
+#endif
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
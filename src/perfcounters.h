@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Hardware performance counters of the executing thread, read with Linux
+/// `perf_event_open` around every guest call. Kernel time is excluded so that
+/// the default `perf_event_paranoid` setting of 2 is sufficient.
+///
+/// Counters that cannot be opened (no PMU in a VM, seccomp, paranoid level 3,
+/// non-Linux hosts) are reported as unavailable instead of failing the call.
+class PerfCounters {
+public:
+  enum Event : uint32_t { Cycles, Instructions, CacheMisses, BranchMisses };
+  static constexpr uint32_t kNumEvents = 4;
+  static constexpr const char *kEventNames[kNumEvents] = {
+      "Cycles", "Instructions", "CacheMisses", "BranchMisses"};
+
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  /// Reset and enable the counters on the calling thread. The counters are
+  /// (re)opened whenever the calling thread changes.
+  void start();
+  /// Disable the counters and accumulate the values of the last call.
+  void stop();
+
+  bool isAvailable(Event E) const noexcept { return Fds[E] >= 0; }
+  /// Empty if at least one counter could be opened.
+  const std::string &getError() const noexcept { return Error; }
+  uint64_t getLast(Event E) const noexcept { return Last[E]; }
+  uint64_t getTotal(Event E) const noexcept { return Total[E]; }
+  uint64_t getCalls() const noexcept { return Calls; }
+
+private:
+  void open();
+  void close();
+
+  std::array<int, kNumEvents> Fds;
+  std::array<uint64_t, kNumEvents> Last = {};
+  std::array<uint64_t, kNumEvents> Total = {};
+  uint64_t Calls = 0;
+  long Tid = -1;
+  bool Running = false;
+  std::string Error;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
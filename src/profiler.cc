@@ -0,0 +1,399 @@
+#include "profiler.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <elf.h>
+#include <execinfo.h>
+#include <link.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+#ifdef __linux__
+/// Profilers with a running timer. The signal handler only dereferences
+/// pointers found here, so foreign SIGPROF timers are passed through.
+constexpr uint32_t kMaxActiveProfilers = 64;
+std::atomic<Profiler *> ActiveProfilers[kMaxActiveProfilers];
+struct sigaction PreviousAction;
+std::once_flag InstallHandlerFlag;
+
+void handleSignal(int Sig, siginfo_t *Info, void *Context) {
+  if (Info != nullptr && Info->si_code == SI_TIMER) {
+    Profiler *P = static_cast<Profiler *>(Info->si_value.sival_ptr);
+    for (uint32_t I = 0; I < kMaxActiveProfilers; I++) {
+      if (P != nullptr && ActiveProfilers[I].load() == P) {
+        P->record();
+        return;
+      }
+    }
+  }
+  /// Not ours, e.g. the V8 CPU profiler.
+  if (PreviousAction.sa_flags & SA_SIGINFO) {
+    if (PreviousAction.sa_sigaction != nullptr) {
+      PreviousAction.sa_sigaction(Sig, Info, Context);
+    }
+  } else if (PreviousAction.sa_handler != SIG_DFL &&
+             PreviousAction.sa_handler != SIG_IGN) {
+    PreviousAction.sa_handler(Sig);
+  }
+}
+
+void installHandler() {
+  std::call_once(InstallHandlerFlag, []() {
+    /// backtrace() loads libgcc on its first call, which is not safe inside
+    /// a signal handler.
+    void *Warmup[1];
+    backtrace(Warmup, 1);
+    struct sigaction Action = {};
+    Action.sa_sigaction = handleSignal;
+    Action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&Action.sa_mask);
+    sigaction(SIGPROF, &Action, &PreviousAction);
+  });
+}
+#endif
+
+bool parseFunctionIndex(const char *Symbol, uint32_t &Index) {
+  /// AOT compiled functions are exported as `f<index>`.
+  if (Symbol == nullptr || Symbol[0] != 'f' || Symbol[1] == '\0') {
+    return false;
+  }
+  char *End = nullptr;
+  unsigned long Value = std::strtoul(Symbol + 1, &End, 10);
+  if (End == nullptr || *End != '\0') {
+    return false;
+  }
+  Index = static_cast<uint32_t>(Value);
+  return true;
+}
+
+#ifdef __linux__
+/// Read the `f<index>` function symbols from the ELF symbol tables of an AOT
+/// library. Both `.symtab` and `.dynsym` are read, so hidden functions are
+/// found as well as exported ones.
+template <typename Callback>
+bool forEachFunctionSymbol(const std::string &Path, Callback &&Func) {
+  std::ifstream Stream(Path.c_str(), std::ios::binary);
+  std::vector<uint8_t> File((std::istreambuf_iterator<char>(Stream)),
+                            std::istreambuf_iterator<char>());
+  if (!Stream.good() && !Stream.eof()) {
+    return false;
+  }
+  if (File.size() < sizeof(Elf64_Ehdr)) {
+    return false;
+  }
+  const auto *Header = reinterpret_cast<const Elf64_Ehdr *>(File.data());
+  if (std::memcmp(Header->e_ident, ELFMAG, SELFMAG) != 0 ||
+      Header->e_ident[EI_CLASS] != ELFCLASS64 ||
+      Header->e_shentsize != sizeof(Elf64_Shdr) ||
+      Header->e_shoff > File.size() ||
+      Header->e_shnum > (File.size() - Header->e_shoff) / sizeof(Elf64_Shdr)) {
+    return false;
+  }
+  const auto *Sections =
+      reinterpret_cast<const Elf64_Shdr *>(File.data() + Header->e_shoff);
+  auto InFile = [&](uint64_t Offset, uint64_t Size) {
+    return Offset <= File.size() && Size <= File.size() - Offset;
+  };
+  for (uint32_t I = 0; I < Header->e_shnum; I++) {
+    const Elf64_Shdr &Table = Sections[I];
+    if ((Table.sh_type != SHT_SYMTAB && Table.sh_type != SHT_DYNSYM) ||
+        Table.sh_link >= Header->e_shnum ||
+        !InFile(Table.sh_offset, Table.sh_size)) {
+      continue;
+    }
+    const Elf64_Shdr &Strings = Sections[Table.sh_link];
+    if (!InFile(Strings.sh_offset, Strings.sh_size)) {
+      continue;
+    }
+    const char *Names =
+        reinterpret_cast<const char *>(File.data() + Strings.sh_offset);
+    const auto *Syms =
+        reinterpret_cast<const Elf64_Sym *>(File.data() + Table.sh_offset);
+    for (uint64_t J = 0; J < Table.sh_size / sizeof(Elf64_Sym); J++) {
+      const Elf64_Sym &Sym = Syms[J];
+      uint32_t Index;
+      if (ELF64_ST_TYPE(Sym.st_info) != STT_FUNC ||
+          Sym.st_shndx == SHN_UNDEF || Sym.st_name >= Strings.sh_size ||
+          std::memchr(Names + Sym.st_name, '\0',
+                      Strings.sh_size - Sym.st_name) == nullptr ||
+          !parseFunctionIndex(Names + Sym.st_name, Index)) {
+        continue;
+      }
+      Func(Sym.st_value, Sym.st_size, Index);
+    }
+  }
+  return true;
+}
+#endif
+
+} // namespace
+
+Profiler::Profiler() : Samples(new Sample[kMaxSamples]) {}
+
+Profiler::~Profiler() {
+  if (Running) {
+    stop("");
+  }
+  flush(true);
+}
+
+bool Profiler::start(uint32_t IntervalUs) {
+#ifdef __linux__
+  if (Running || IntervalUs == 0) {
+    return false;
+  }
+  installHandler();
+
+  uint32_t Slot = 0;
+  for (; Slot < kMaxActiveProfilers; Slot++) {
+    Profiler *Expected = nullptr;
+    if (ActiveProfilers[Slot].compare_exchange_strong(Expected, this)) {
+      break;
+    }
+  }
+  if (Slot == kMaxActiveProfilers) {
+    return false;
+  }
+
+  SampleCount = 0;
+  Dropped = 0;
+  struct sigevent Event = {};
+  Event.sigev_notify = SIGEV_THREAD_ID;
+  Event.sigev_signo = SIGPROF;
+  Event.sigev_value.sival_ptr = this;
+#ifdef sigev_notify_thread_id
+  Event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+#else
+  Event._sigev_un._tid = static_cast<pid_t>(syscall(SYS_gettid));
+#endif
+  if (timer_create(CLOCK_THREAD_CPUTIME_ID, &Event, &Timer) != 0) {
+    ActiveProfilers[Slot] = nullptr;
+    return false;
+  }
+  struct itimerspec Spec = {};
+  Spec.it_interval.tv_sec = IntervalUs / 1000000;
+  Spec.it_interval.tv_nsec = (IntervalUs % 1000000) * 1000;
+  Spec.it_value = Spec.it_interval;
+  if (timer_settime(Timer, 0, &Spec, nullptr) != 0) {
+    timer_delete(Timer);
+    ActiveProfilers[Slot] = nullptr;
+    return false;
+  }
+  Running = true;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Profiler::record() noexcept {
+#ifdef __linux__
+  uint32_t Index = SampleCount.fetch_add(1);
+  if (Index >= kMaxSamples) {
+    SampleCount = kMaxSamples;
+    Dropped++;
+    return;
+  }
+  Sample &S = Samples[Index];
+  S.Depth = static_cast<uint32_t>(backtrace(S.Frames, kMaxDepth));
+#endif
+}
+
+void Profiler::loadSymbols(const std::string &ArtifactPath) {
+#ifdef __linux__
+  if (ArtifactPath == SymbolsPath) {
+    return;
+  }
+  SymbolsPath = ArtifactPath;
+  Symbols.clear();
+  if (ArtifactPath.empty()) {
+    return;
+  }
+  forEachFunctionSymbol(
+      ArtifactPath, [this](uint64_t Address, uint64_t Size, uint32_t Index) {
+        Symbols.push_back({Address, Size, Index});
+      });
+  std::sort(Symbols.begin(), Symbols.end(),
+            [](const FunctionSymbol &A, const FunctionSymbol &B) {
+              return A.Address < B.Address;
+            });
+#endif
+}
+
+bool Profiler::lookupSymbol(uint64_t Address, uint32_t &Index) const {
+  auto It = std::upper_bound(
+      Symbols.begin(), Symbols.end(), Address,
+      [](uint64_t A, const FunctionSymbol &Sym) { return A < Sym.Address; });
+  if (It == Symbols.begin()) {
+    return false;
+  }
+  --It;
+  if (It->Size != 0 && Address - It->Address >= It->Size) {
+    return false;
+  }
+  Index = It->Index;
+  return true;
+}
+
+void Profiler::resolveArtifact(const std::string &ArtifactPath) {
+#ifdef __linux__
+  LoadBase = 0;
+  Segments.clear();
+  if (ArtifactPath.empty()) {
+    return;
+  }
+  struct Search {
+    const std::string &Path;
+    bool Equivalent;
+    Profiler *Self;
+  };
+  auto Visit = [](struct dl_phdr_info *Info, size_t, void *Data) -> int {
+    Search &S = *static_cast<Search *>(Data);
+    if (Info->dlpi_name == nullptr || Info->dlpi_name[0] == '\0') {
+      return 0;
+    }
+    std::error_code EC;
+    if (S.Equivalent
+            ? !std::filesystem::equivalent(S.Path, Info->dlpi_name, EC)
+            : S.Path != Info->dlpi_name) {
+      return 0;
+    }
+    S.Self->LoadBase = Info->dlpi_addr;
+    for (uint32_t I = 0; I < Info->dlpi_phnum; I++) {
+      const ElfW(Phdr) &Header = Info->dlpi_phdr[I];
+      if (Header.p_type == PT_LOAD) {
+        const uint64_t Start = Info->dlpi_addr + Header.p_vaddr;
+        S.Self->Segments.emplace_back(Start, Start + Header.p_memsz);
+      }
+    }
+    return 1;
+  };
+  /// Compare names first, the file is only stat'ed against every loaded
+  /// object if it was loaded through another path.
+  Search ByName = {ArtifactPath, false, this};
+  if (dl_iterate_phdr(Visit, &ByName) == 0) {
+    Search ByFile = {ArtifactPath, true, this};
+    dl_iterate_phdr(Visit, &ByFile);
+  }
+#endif
+}
+
+std::string Profiler::frameName(void *Frame) const {
+#ifdef __linux__
+  const uint64_t Address = reinterpret_cast<uintptr_t>(Frame);
+  bool InArtifact = false;
+  for (const auto &Segment : Segments) {
+    if (Address >= Segment.first && Address < Segment.second) {
+      InArtifact = true;
+      break;
+    }
+  }
+  if (!InArtifact) {
+    return "";
+  }
+  uint32_t Index;
+  if (Symbols.empty()) {
+    /// Only the exported symbols are known without the symbol tables.
+    Dl_info Info;
+    if (dladdr(Frame, &Info) == 0 ||
+        !parseFunctionIndex(Info.dli_sname, Index)) {
+      return "";
+    }
+  } else if (!lookupSymbol(Address - LoadBase, Index)) {
+    /// Symbol values of a shared library are relative to its load base.
+    return "";
+  }
+  auto It = FunctionNames.find(Index);
+  if (It != FunctionNames.end()) {
+    return It->second;
+  }
+  return "wasm-function[" + std::to_string(Index) + "]";
+#else
+  return "";
+#endif
+}
+
+void Profiler::stop(const std::string &ArtifactPath) {
+#ifdef __linux__
+  if (!Running) {
+    return;
+  }
+  timer_delete(Timer);
+  for (uint32_t I = 0; I < kMaxActiveProfilers; I++) {
+    Profiler *Expected = this;
+    ActiveProfilers[I].compare_exchange_strong(Expected, nullptr);
+  }
+  Running = false;
+  loadSymbols(ArtifactPath);
+
+  /// Fold the stacks now, the AOT library is unloaded with the VM.
+  uint32_t Count = std::min(SampleCount.load(), kMaxSamples);
+  if (Count > 0) {
+    resolveArtifact(ArtifactPath);
+  }
+  for (uint32_t I = 0; I < Count; I++) {
+    const Sample &S = Samples[I];
+    std::string Stack;
+    /// backtrace() lists the innermost frame first.
+    for (uint32_t J = S.Depth; J > 0; J--) {
+      std::string Name = frameName(S.Frames[J - 1]);
+      if (Name.empty()) {
+        continue;
+      }
+      if (!Stack.empty()) {
+        Stack += ';';
+      }
+      Stack += Name;
+    }
+    if (Stack.empty()) {
+      Stack = "[wasmedge]";
+    }
+    Folded[Stack]++;
+  }
+  TotalSamples += Count;
+  DroppedSamples += Dropped;
+  Dirty = Dirty || Count > 0;
+#endif
+}
+
+bool Profiler::writeCollapsed(const std::string &Path) const {
+  std::ofstream File(Path.c_str(), std::ios::trunc);
+  if (!File.good()) {
+    return false;
+  }
+  for (const auto &[Stack, Count] : Folded) {
+    File << Stack << ' ' << Count << '\n';
+  }
+  return File.good();
+}
+
+bool Profiler::flush(bool Force) {
+  if (OutputPath.empty() || !Dirty) {
+    return true;
+  }
+  const auto Now = std::chrono::steady_clock::now();
+  if (!Force && Now - LastFlush < std::chrono::milliseconds(kFlushIntervalMs)) {
+    return true;
+  }
+  LastFlush = Now;
+  Dirty = false;
+  return writeCollapsed(OutputPath);
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
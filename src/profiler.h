@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Sampling profiler for guest code.
+///
+/// A per-thread CPU time timer interrupts the executing thread and records
+/// the native call stack. Frames inside the AOT compiled library are mapped
+/// to wasm function indexes through its `f<index>` symbols, and then to names
+/// through the wasm name section. The symbols are read from the symbol tables
+/// of the library file; `dladdr` is only used when the file can not be
+/// parsed, as it only sees exported symbols. The mapping of the library is
+/// looked up once per call and frames are classified by address. Frames
+/// outside of AOT code (the interpreter, host functions) are folded into one
+/// `[wasmedge]` frame, so in interpreter mode only the total time is
+/// attributed.
+class Profiler {
+public:
+  static constexpr uint32_t kMaxDepth = 64;
+  static constexpr uint32_t kMaxSamples = 4096;
+
+  struct Sample {
+    uint32_t Depth;
+    void *Frames[kMaxDepth];
+  };
+
+  Profiler();
+  ~Profiler();
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  void setFunctionNames(std::map<uint32_t, std::string> &&Names) {
+    FunctionNames = std::move(Names);
+    HasFunctionNames = true;
+  }
+  bool hasFunctionNames() const noexcept { return HasFunctionNames; }
+
+  /// Start sampling the calling thread every `IntervalUs` of its CPU time.
+  bool start(uint32_t IntervalUs);
+  /// Stop sampling and fold the recorded stacks. `ArtifactPath` is the AOT
+  /// library which was executed, or empty in interpreter mode.
+  void stop(const std::string &ArtifactPath);
+
+  /// Write the folded stacks in collapsed-stack format
+  /// (`outer;inner count` per line), as consumed by flamegraph.pl.
+  bool writeCollapsed(const std::string &Path) const;
+
+  /// Set the file which `flush()` writes to.
+  void setOutput(const std::string &Path) { OutputPath = Path; }
+  /// Write the folded stacks to the output file if new samples were folded,
+  /// at most once per `kFlushIntervalMs` unless `Force` is set.
+  bool flush(bool Force);
+  static constexpr uint64_t kFlushIntervalMs = 1000;
+
+  uint64_t getSampleCount() const noexcept { return TotalSamples; }
+  uint64_t getDroppedCount() const noexcept { return DroppedSamples; }
+
+  /// Called from the signal handler.
+  void record() noexcept;
+
+private:
+  struct FunctionSymbol {
+    uint64_t Address;
+    uint64_t Size;
+    uint32_t Index;
+  };
+
+  std::string frameName(void *Frame) const;
+  bool lookupSymbol(uint64_t Address, uint32_t &Index) const;
+  void loadSymbols(const std::string &ArtifactPath);
+  /// Find where the artifact is mapped, so frames are classified by address.
+  void resolveArtifact(const std::string &ArtifactPath);
+
+  std::map<uint32_t, std::string> FunctionNames;
+  bool HasFunctionNames = false;
+  std::unique_ptr<Sample[]> Samples;
+  std::atomic<uint32_t> SampleCount{0};
+  std::atomic<uint64_t> Dropped{0};
+  std::map<std::string, uint64_t> Folded;
+  uint64_t TotalSamples = 0;
+  uint64_t DroppedSamples = 0;
+  bool Running = false;
+  std::string SymbolsPath;
+  std::vector<FunctionSymbol> Symbols;
+  uint64_t LoadBase = 0;
+  std::vector<std::pair<uint64_t, uint64_t>> Segments;
+  std::string OutputPath;
+  bool Dirty = false;
+  std::chrono::steady_clock::time_point LastFlush;
+#ifdef __linux__
+  timer_t Timer;
+#endif
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,186 @@
+#include "registry.h"
+#include "compiler.h"
+#include "utils.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+/// Parse with the proposals the VMs are created with.
+template <typename ParseT>
+WasmEdge_ASTModuleContext *parseModule(ParseT &&Parse) {
+  WasmEdge_ConfigureContext *Conf = createConfigure();
+  WasmEdge_LoaderContext *Loader = WasmEdge_LoaderCreate(Conf);
+  WasmEdge_ASTModuleContext *AST = nullptr;
+  const bool Parsed = Parse(Loader, &AST);
+  WasmEdge_LoaderDelete(Loader);
+  WasmEdge_ConfigureDelete(Conf);
+  if (!Parsed) {
+    WasmEdge_ASTModuleDelete(AST);
+    return nullptr;
+  }
+  return AST;
+}
+
+/// Hash the contents of an open file, in the same way as in-memory bytecode.
+bool hashFile(int FD, ModuleDigest &Digest) {
+  Sha256 Hash;
+  Digest.Size = 0;
+  std::vector<uint8_t> Buffer(64 * 1024);
+  while (true) {
+    const ssize_t Read = pread(FD, Buffer.data(), Buffer.size(), Digest.Size);
+    if (Read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (Read < 0) {
+      return false;
+    }
+    if (Read == 0) {
+      break;
+    }
+    Hash.update(Buffer.data(), Read);
+    Digest.Size += Read;
+  }
+  Digest.Hash = Hash.finish();
+  return true;
+}
+
+bool isSameFile(const struct stat &A, const struct stat &B) {
+  return A.st_dev == B.st_dev && A.st_ino == B.st_ino &&
+         A.st_size == B.st_size && A.st_mtim.tv_sec == B.st_mtim.tv_sec &&
+         A.st_mtim.tv_nsec == B.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+ModuleRegistry &ModuleRegistry::instance() {
+  /// Never destroyed: VMs of worker threads may outlive static destruction.
+  static ModuleRegistry *Registry = new ModuleRegistry();
+  return *Registry;
+}
+
+template <typename ParseT, typename DigestT>
+std::shared_ptr<const SharedModule>
+ModuleRegistry::load(const std::string &Key, ParseT &&Parse, DigestT &&Digest) {
+  std::shared_ptr<Entry> E;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto &Slot = Entries[Key];
+    if (!Slot) {
+      Slot = std::make_shared<Entry>();
+    }
+    E = Slot;
+    pruneLocked();
+  }
+
+  std::lock_guard<std::mutex> Lock(E->Mutex);
+  if (auto Module = E->Module.lock()) {
+    Hits++;
+    return Module;
+  }
+  Misses++;
+  WasmEdge_ASTModuleContext *AST = parseModule(Parse);
+  if (AST == nullptr) {
+    return nullptr;
+  }
+  auto Module = std::make_shared<const SharedModule>(AST, Digest());
+  E->Module = Module;
+  return Module;
+}
+
+std::shared_ptr<const SharedModule>
+ModuleRegistry::loadFile(const std::string &Path) {
+  /// The key and the digest come from the file opened here. AOT libraries
+  /// can only be loaded by path, so the path is checked to still name this
+  /// file after parsing; a file replaced meanwhile fails the load instead of
+  /// pairing its AST with the digest of another file.
+  int FD = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (FD < 0) {
+    return nullptr;
+  }
+  struct stat Opened;
+  if (fstat(FD, &Opened) != 0 || !S_ISREG(Opened.st_mode)) {
+    close(FD);
+    return nullptr;
+  }
+  std::string Key = "file:" + Path + ":" + std::to_string(Opened.st_size) +
+                    ":" + std::to_string(Opened.st_mtim.tv_sec) + "." +
+                    std::to_string(Opened.st_mtim.tv_nsec);
+  ModuleDigest Digest;
+  auto Module = load(
+      Key,
+      [&](WasmEdge_LoaderContext *Loader, WasmEdge_ASTModuleContext **AST) {
+        if (!hashFile(FD, Digest) ||
+            Digest.Size != static_cast<uint64_t>(Opened.st_size) ||
+            !WasmEdge_ResultOK(
+                WasmEdge_LoaderParseFromFile(Loader, AST, Path.c_str()))) {
+          return false;
+        }
+        struct stat Parsed;
+        return stat(Path.c_str(), &Parsed) == 0 && isSameFile(Parsed, Opened);
+      },
+      [&Digest]() { return Digest; });
+  close(FD);
+  return Module;
+}
+
+std::shared_ptr<const SharedModule>
+ModuleRegistry::loadBuffer(const std::vector<uint8_t> &Data) {
+  const ModuleDigest Digest{Sha256::hash(Data.data(), Data.size()),
+                            Data.size()};
+  std::string Key = "data:" + Sha256::toHex(Digest.Hash) + ":" +
+                    std::to_string(Digest.Size);
+  return load(
+      Key,
+      [&Data](WasmEdge_LoaderContext *Loader, WasmEdge_ASTModuleContext **AST) {
+        return WasmEdge_ResultOK(WasmEdge_LoaderParseFromBuffer(
+            Loader, AST, Data.data(), Data.size()));
+      },
+      [&Digest]() { return Digest; });
+}
+
+std::shared_ptr<std::mutex>
+ModuleRegistry::compileLock(const std::string &Path) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto &Slot = CompileLocks[Path];
+  auto CompileMutex = Slot.lock();
+  if (!CompileMutex) {
+    CompileMutex = std::make_shared<std::mutex>();
+    Slot = CompileMutex;
+    pruneLocked();
+  }
+  return CompileMutex;
+}
+
+void ModuleRegistry::pruneLocked() {
+  /// Drop the entries of modules which are no longer used by any VM.
+  for (auto It = Entries.begin(); It != Entries.end();) {
+    if (It->second->Module.expired() && It->second.use_count() == 1) {
+      It = Entries.erase(It);
+    } else {
+      ++It;
+    }
+  }
+  for (auto It = CompileLocks.begin(); It != CompileLocks.end();) {
+    if (It->second.expired()) {
+      It = CompileLocks.erase(It);
+    } else {
+      ++It;
+    }
+  }
+}
+
+uint64_t ModuleRegistry::getModuleCount() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  pruneLocked();
+  return Entries.size();
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
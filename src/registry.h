@@ -0,0 +1,84 @@
+#pragma once
+
+#include "validation.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// A parsed module which can be instantiated by any number of VMs. The VM
+/// copies the AST when loading it, so the shared AST is never modified. For
+/// AOT artifacts the copy shares the loaded shared object.
+class SharedModule {
+public:
+  SharedModule(WasmEdge_ASTModuleContext *AST, const ModuleDigest &Digest)
+      : AST(AST), Digest(Digest) {}
+  ~SharedModule() { WasmEdge_ASTModuleDelete(AST); }
+  SharedModule(const SharedModule &) = delete;
+  SharedModule &operator=(const SharedModule &) = delete;
+
+  const WasmEdge_ASTModuleContext *get() const noexcept { return AST; }
+  /// Hash and size of the contents the module was parsed from.
+  const ModuleDigest &getDigest() const noexcept { return Digest; }
+
+private:
+  WasmEdge_ASTModuleContext *AST;
+  ModuleDigest Digest;
+};
+
+/// Process-wide registry of parsed modules, shared by the VMs of all
+/// `napi_env`s (the main thread and every worker thread).
+///
+/// Entries are keyed by the content hash of in-memory bytecode, or by path,
+/// size and modification time of files, so a rewritten AOT artifact is
+/// loaded again. The registry only keeps weak references: a module lives as
+/// long as a VM object uses it.
+class ModuleRegistry {
+public:
+  static ModuleRegistry &instance();
+
+  /// Return the shared module, parsing it if no VM of the process holds it.
+  /// Concurrent requests for the same module parse it once. Returns nullptr
+  /// if parsing fails.
+  std::shared_ptr<const SharedModule> loadFile(const std::string &Path);
+  std::shared_ptr<const SharedModule>
+  loadBuffer(const std::vector<uint8_t> &Data);
+
+  /// Lock held while an AOT artifact is written, so threads compiling the
+  /// same module wait for the first one instead of compiling it again.
+  std::shared_ptr<std::mutex> compileLock(const std::string &Path);
+
+  uint64_t getModuleCount();
+  uint64_t getHits() const noexcept { return Hits; }
+  uint64_t getMisses() const noexcept { return Misses; }
+
+private:
+  struct Entry {
+    std::mutex Mutex;
+    std::weak_ptr<const SharedModule> Module;
+  };
+
+  template <typename ParseT, typename DigestT>
+  std::shared_ptr<const SharedModule>
+  load(const std::string &Key, ParseT &&Parse, DigestT &&Digest);
+
+  /// Requires Mutex to be held.
+  void pruneLocked();
+
+  std::mutex Mutex;
+  std::map<std::string, std::shared_ptr<Entry>> Entries;
+  std::map<std::string, std::weak_ptr<std::mutex>> CompileLocks;
+  std::atomic<uint64_t> Hits{0};
+  std::atomic<uint64_t> Misses{0};
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
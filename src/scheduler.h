@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Priority classes of queued calls, highest first.
+enum class Priority : uint32_t { Interactive = 0, Normal = 1, Batch = 2 };
+constexpr uint32_t kNumPriorities = 3;
+
+inline bool parsePriority(const std::string &Name, Priority &P) {
+  if (Name == "interactive") {
+    P = Priority::Interactive;
+  } else if (Name == "normal") {
+    P = Priority::Normal;
+  } else if (Name == "batch") {
+    P = Priority::Batch;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+struct SchedulerStatistics {
+  uint64_t Dispatched = 0;
+  uint64_t RejectedFull = 0;
+  uint64_t Expired = 0;
+  /// Time between the call and its start, in milliseconds.
+  double LastWait = 0;
+  double TotalWait = 0;
+  double MaxWait = 0;
+};
+
+/// Bounded admission queue for calls waiting for a busy VM instance.
+///
+/// Entries are dispatched by priority class, and in arrival order within a
+/// class. Entries whose deadline has passed are dropped instead of being
+/// executed, and a full queue rejects new entries at once. The queue does
+/// not keep time itself; the owner calls expire() when nextDeadline() passes.
+template <typename T> class AdmissionQueue {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  void setCapacity(size_t Value) noexcept { Capacity = Value; }
+  size_t getCapacity() const noexcept { return Capacity; }
+  size_t size() const noexcept {
+    size_t Size = 0;
+    for (const auto &Queue : Queues) {
+      Size += Queue.size();
+    }
+    return Size;
+  }
+  const SchedulerStatistics &getStatistics() const noexcept { return Stat; }
+
+  /// Enqueue `Item`. It is only moved from if there was room.
+  bool push(T &Item, Priority P, Clock::time_point Deadline) {
+    if (size() >= Capacity) {
+      Stat.RejectedFull++;
+      return false;
+    }
+    Queues[static_cast<uint32_t>(P)].push_back(
+        {std::move(Item), Clock::now(), Deadline});
+    return true;
+  }
+
+  /// Take the next entry to run. Expired entries of all classes are moved to
+  /// `Expired`, so that the caller can reject them.
+  bool pop(T &Item, std::vector<T> &Expired) {
+    const Clock::time_point Now = Clock::now();
+    expire(Now, Expired);
+    for (auto &Queue : Queues) {
+      if (!Queue.empty()) {
+        Item = std::move(Queue.front().Item);
+        recordDispatch(Queue.front().Enqueued, Now);
+        Queue.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Move the entries whose deadline is not after `Now` to `Expired`.
+  void expire(Clock::time_point Now, std::vector<T> &Expired) {
+    for (auto &Queue : Queues) {
+      for (auto It = Queue.begin(); It != Queue.end();) {
+        if (It->Deadline <= Now) {
+          Expired.push_back(std::move(It->Item));
+          It = Queue.erase(It);
+          Stat.Expired++;
+        } else {
+          ++It;
+        }
+      }
+    }
+  }
+
+  /// The earliest deadline of the queued entries, or `time_point::max()`.
+  Clock::time_point nextDeadline() const {
+    Clock::time_point Next = Clock::time_point::max();
+    for (const auto &Queue : Queues) {
+      for (const auto &E : Queue) {
+        Next = std::min(Next, E.Deadline);
+      }
+    }
+    return Next;
+  }
+
+  /// Take the first entry for which `Match` returns true out of the queue,
+  /// e.g. because its call was aborted.
+  template <typename MatchT> bool remove(MatchT &&Match, T &Item) {
+    for (auto &Queue : Queues) {
+      for (auto It = Queue.begin(); It != Queue.end(); ++It) {
+        if (Match(It->Item)) {
+          Item = std::move(It->Item);
+          Queue.erase(It);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /// Record a call which started without waiting in the queue.
+  void recordDispatch() {
+    const Clock::time_point Now = Clock::now();
+    recordDispatch(Now, Now);
+  }
+  /// Record a call which was dropped because its deadline had passed.
+  void recordExpired() { Stat.Expired++; }
+
+private:
+  struct Entry {
+    T Item;
+    Clock::time_point Enqueued;
+    Clock::time_point Deadline;
+  };
+
+  void recordDispatch(Clock::time_point Enqueued, Clock::time_point Now) {
+    const double Wait =
+        std::chrono::duration<double, std::milli>(Now - Enqueued).count();
+    Stat.Dispatched++;
+    Stat.LastWait = Wait;
+    Stat.TotalWait += Wait;
+    Stat.MaxWait = std::max(Stat.MaxWait, Wait);
+  }
+
+  size_t Capacity = 1024;
+  std::deque<Entry> Queues[kNumPriorities];
+  SchedulerStatistics Stat;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
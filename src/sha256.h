@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Incremental SHA-256 (FIPS 180-4). Used wherever a digest of module
+/// contents is persisted or shared between processes, where a hash of the
+/// standard library or Boost would change between builds.
+class Sha256 {
+public:
+  using Digest = std::array<uint8_t, 32>;
+
+  Sha256() noexcept { reset(); }
+
+  void reset() noexcept;
+  void update(const uint8_t *Data, size_t Size) noexcept;
+  /// Finish the hash. The object must be reset before it is updated again.
+  Digest finish() noexcept;
+
+  static Digest hash(const uint8_t *Data, size_t Size) noexcept {
+    Sha256 H;
+    H.update(Data, Size);
+    return H.finish();
+  }
+  static std::string toHex(const Digest &D);
+
+private:
+  void compress(const uint8_t *Block) noexcept;
+
+  uint32_t State[8];
+  uint8_t Buffer[64];
+  size_t Buffered;
+  uint64_t Length;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
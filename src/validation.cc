@@ -0,0 +1,120 @@
+#include "validation.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+const char *kRecordMagic = "wasmedge-validated-2";
+
+/// The record directory, or an empty string if it is not private to the
+/// effective user, e.g. because another user created it first.
+const std::string &recordDir() {
+  static const std::string Dir = []() -> std::string {
+    const std::string Path =
+        "/tmp/wasmedge-validated-" + std::to_string(geteuid());
+    if (mkdir(Path.c_str(), 0700) != 0 && errno != EEXIST) {
+      return "";
+    }
+    struct stat Stat;
+    if (lstat(Path.c_str(), &Stat) != 0 || !S_ISDIR(Stat.st_mode) ||
+        Stat.st_uid != geteuid() || (Stat.st_mode & 0077) != 0) {
+      return "";
+    }
+    return Path;
+  }();
+  return Dir;
+}
+
+std::string recordPath(const ModuleDigest &Digest) {
+  return recordDir() + "/" + Sha256::toHex(Digest.Hash) + "." +
+         std::to_string(Digest.Size);
+}
+
+/// The record body; the proposals the VMs are created with are fixed, so the
+/// WasmEdge version covers the validation rules.
+std::string recordBody(const ModuleDigest &Digest) {
+  std::ostringstream Body;
+  Body << kRecordMagic << ' ' << WasmEdge_VersionGet() << ' '
+       << Sha256::toHex(Digest.Hash) << ' ' << Digest.Size << '\n';
+  return Body.str();
+}
+
+bool readRecord(const ModuleDigest &Digest) {
+  if (recordDir().empty()) {
+    return false;
+  }
+  int Fd = open(recordPath(Digest).c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+  if (Fd < 0) {
+    return false;
+  }
+  struct stat Stat;
+  char Buffer[256];
+  ssize_t Read = -1;
+  if (fstat(Fd, &Stat) == 0 && S_ISREG(Stat.st_mode) &&
+      Stat.st_uid == geteuid() && (Stat.st_mode & 0022) == 0) {
+    Read = read(Fd, Buffer, sizeof(Buffer));
+  }
+  close(Fd);
+  return Read > 0 &&
+         std::string(Buffer, static_cast<size_t>(Read)) == recordBody(Digest);
+}
+
+void writeRecord(const ModuleDigest &Digest) {
+  if (recordDir().empty()) {
+    return;
+  }
+  /// Write to a private file first, readers never see a partial record.
+  const std::string Path = recordPath(Digest);
+  const std::string TmpPath = Path + "." + std::to_string(getpid());
+  const std::string Body = recordBody(Digest);
+  int Fd = open(TmpPath.c_str(),
+                O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+  if (Fd < 0) {
+    return;
+  }
+  const bool Written =
+      write(Fd, Body.data(), Body.size()) == static_cast<ssize_t>(Body.size());
+  if (close(Fd) != 0 || !Written ||
+      std::rename(TmpPath.c_str(), Path.c_str()) != 0) {
+    std::remove(TmpPath.c_str());
+  }
+}
+
+} // namespace
+
+ValidationRecord &ValidationRecord::instance() {
+  /// Never destroyed: VMs of worker threads may outlive static destruction.
+  static ValidationRecord *Record = new ValidationRecord();
+  return *Record;
+}
+
+bool ValidationRecord::isValidated(const ModuleDigest &Digest) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  if (Validated.count(Digest) != 0) {
+    return true;
+  }
+  if (readRecord(Digest)) {
+    Validated.insert(Digest);
+    return true;
+  }
+  return false;
+}
+
+void ValidationRecord::recordValidated(const ModuleDigest &Digest) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  if (Validated.insert(Digest).second) {
+    writeRecord(Digest);
+  }
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
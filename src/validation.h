@@ -0,0 +1,47 @@
+#pragma once
+
+#include "sha256.h"
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Identifies module contents which passed validation: the SHA-256 and the
+/// size of the bytecode or AOT artifact.
+struct ModuleDigest {
+  Sha256::Digest Hash = {};
+  uint64_t Size = 0;
+
+  bool operator<(const ModuleDigest &Other) const noexcept {
+    return Hash < Other.Hash || (Hash == Other.Hash && Size < Other.Size);
+  }
+};
+
+/// Process-wide record of validated modules.
+///
+/// Every digest is also persisted as a small record in a directory private
+/// to the user (`/tmp/wasmedge-validated-<uid>/<sha256>.<size>`), so other
+/// processes of the same user can trust it as well. The directory is only
+/// used if it is owned by the effective user and has mode 0700, and a record
+/// only if it is a regular file owned by that user which is not writable by
+/// group or others. Otherwise validated modules are only remembered in the
+/// process. A record holds the WasmEdge version; records written by another
+/// version are ignored.
+class ValidationRecord {
+public:
+  static ValidationRecord &instance();
+
+  bool isValidated(const ModuleDigest &Digest);
+  void recordValidated(const ModuleDigest &Digest);
+
+private:
+  std::mutex Mutex;
+  std::set<ModuleDigest> Validated;
+};
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,140 @@
+#include "values.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+/// Numbers bound for an integer parameter must be integral and fit the
+/// signed or the unsigned range of the type, the same rule as for BigInt.
+bool isIntegral(double D, double Min, double Max) {
+  return std::isfinite(D) && std::trunc(D) == D && D >= Min && D <= Max;
+}
+
+} // namespace
+
+bool toWasmEdgeValue(const Napi::Value &Arg, const WasmEdge_ValType Type,
+                     WasmEdge_Value &Value) {
+  if (Arg.IsBigInt()) {
+    bool Lossless = false;
+    int64_t V = Arg.As<Napi::BigInt>().Int64Value(&Lossless);
+    if (!Lossless) {
+      /// Values in (INT64_MAX, UINT64_MAX] are accepted as unsigned.
+      V = static_cast<int64_t>(Arg.As<Napi::BigInt>().Uint64Value(&Lossless));
+    }
+    if (!Lossless) {
+      return false;
+    }
+    switch (Type) {
+    case WasmEdge_ValType_I32:
+      /// Accept both the signed and the unsigned 32-bit range, like the
+      /// 64-bit case above; anything wider would be silently truncated.
+      if (V < INT32_MIN || V > static_cast<int64_t>(UINT32_MAX)) {
+        return false;
+      }
+      Value = WasmEdge_ValueGenI32(static_cast<int32_t>(V));
+      return true;
+    case WasmEdge_ValType_I64:
+      Value = WasmEdge_ValueGenI64(V);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  if (!Arg.IsNumber()) {
+    return false;
+  }
+  Napi::Number Num = Arg.As<Napi::Number>();
+  switch (Type) {
+  case WasmEdge_ValType_I32: {
+    const double D = Num.DoubleValue();
+    if (!isIntegral(D, INT32_MIN, UINT32_MAX)) {
+      return false;
+    }
+    Value = WasmEdge_ValueGenI32(
+        D < 0 ? static_cast<int32_t>(D)
+              : static_cast<int32_t>(static_cast<uint32_t>(D)));
+    return true;
+  }
+  case WasmEdge_ValType_I64: {
+    /// 2^63 and 2^64 are exact doubles, the largest double below 2^64 is
+    /// accepted as unsigned.
+    const double D = Num.DoubleValue();
+    if (!isIntegral(D, -9223372036854775808.0, 18446744073709549568.0)) {
+      return false;
+    }
+    Value = WasmEdge_ValueGenI64(
+        D < 9223372036854775808.0
+            ? static_cast<int64_t>(D)
+            : static_cast<int64_t>(static_cast<uint64_t>(D)));
+    return true;
+  }
+  case WasmEdge_ValType_F32:
+    Value = WasmEdge_ValueGenF32(Num.FloatValue());
+    return true;
+  case WasmEdge_ValType_F64:
+    Value = WasmEdge_ValueGenF64(Num.DoubleValue());
+    return true;
+  default:
+    return false;
+  }
+}
+
+Napi::Value toNapiValue(const Napi::Env &Env, const WasmEdge_Value &Value,
+                        bool IsUnsigned) {
+  switch (Value.Type) {
+  case WasmEdge_ValType_I32:
+    if (IsUnsigned) {
+      return Napi::Number::New(
+          Env, static_cast<uint32_t>(WasmEdge_ValueGetI32(Value)));
+    }
+    return Napi::Number::New(Env, WasmEdge_ValueGetI32(Value));
+  case WasmEdge_ValType_I64:
+    if (IsUnsigned) {
+      return Napi::BigInt::New(
+          Env, static_cast<uint64_t>(WasmEdge_ValueGetI64(Value)));
+    }
+    return Napi::BigInt::New(Env, WasmEdge_ValueGetI64(Value));
+  case WasmEdge_ValType_F32:
+    return Napi::Number::New(Env, WasmEdge_ValueGetF32(Value));
+  case WasmEdge_ValType_F64:
+    return Napi::Number::New(Env, WasmEdge_ValueGetF64(Value));
+  default:
+    /// V128 and reference types have no JS counterpart.
+    return Env.Undefined();
+  }
+}
+
+bool getFunctionType(WasmEdge_VMContext *VM, const std::string &FuncName,
+                     std::vector<WasmEdge_ValType> &Params,
+                     std::vector<WasmEdge_ValType> &Returns) {
+  Params.clear();
+  Returns.clear();
+  WasmEdge_String WasmFuncName =
+      WasmEdge_StringCreateByCString(FuncName.c_str());
+  /// Look the function up in the store, the module may have been
+  /// instantiated without the VM workflow (TrustValidated).
+  const WasmEdge_FunctionInstanceContext *FuncInst =
+      WasmEdge_StoreFindFunction(WasmEdge_VMGetStoreContext(VM), WasmFuncName);
+  WasmEdge_StringDelete(WasmFuncName);
+  if (FuncInst == nullptr) {
+    return false;
+  }
+  const WasmEdge_FunctionTypeContext *FuncType =
+      WasmEdge_FunctionInstanceGetFunctionType(FuncInst);
+  if (FuncType == nullptr) {
+    return false;
+  }
+  Params.resize(WasmEdge_FunctionTypeGetParametersLength(FuncType));
+  WasmEdge_FunctionTypeGetParameters(FuncType, Params.data(), Params.size());
+  Returns.resize(WasmEdge_FunctionTypeGetReturnsLength(FuncType));
+  WasmEdge_FunctionTypeGetReturns(FuncType, Returns.data(), Returns.size());
+  return true;
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <napi.h>
+#include <vector>
+#include <wasmedge/wasmedge.h>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Convert a JS Number or BigInt into a WasmEdge value of the given type.
+/// Returns false if the JS value cannot represent the requested type; a
+/// Number for an integer type must be integral and in range.
+bool toWasmEdgeValue(const Napi::Value &Arg, const WasmEdge_ValType Type,
+                     WasmEdge_Value &Value);
+
+/// Convert a WasmEdge value into a JS value. I64 values are returned as BigInt
+/// so that values above 2^53 are not truncated.
+Napi::Value toNapiValue(const Napi::Env &Env, const WasmEdge_Value &Value,
+                        bool IsUnsigned = false);
+
+/// Get the parameter and return types of the exported function `FuncName`.
+/// Returns false if the function is not found.
+bool getFunctionType(WasmEdge_VMContext *VM, const std::string &FuncName,
+                     std::vector<WasmEdge_ValType> &Params,
+                     std::vector<WasmEdge_ValType> &Returns);
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -2,14 +2,11 @@
 
 #include <limits>
 #include <wasmedge/wasmedge.h>
-#include <wasmedge/wasmedge-tensorflow.h>
-#include <wasmedge/wasmedge-tensorflowlite.h>
-#include <wasmedge/wasmedge-image.h>
 
 #include <boost/functional/hash.hpp>
+#include <cmath>
 #include <iostream>
-
-Napi::FunctionReference WasmEdgeAddon::Constructor;
+#include <malloc.h>
 
 Napi::Object WasmEdgeAddon::Init(Napi::Env Env, Napi::Object Exports) {
   Napi::HandleScope Scope(Env);
@@ -19,18 +16,39 @@ Napi::Object WasmEdgeAddon::Init(Napi::Env Env, Napi::Object Exports) {
   Napi::Function Func = DefineClass(
       Env, "VM",
       {InstanceMethod("GetStatistics", &WasmEdgeAddon::GetStatistics),
+       InstanceMethod("GetMemFSFiles", &WasmEdgeAddon::GetMemFSFiles),
        InstanceMethod("Start", &WasmEdgeAddon::RunStart),
        InstanceMethod("Compile", &WasmEdgeAddon::RunCompile),
        InstanceMethod("Run", &WasmEdgeAddon::Run),
-       InstanceMethod("RunInt", &WasmEdgeAddon::RunInt),
-       InstanceMethod("RunUInt", &WasmEdgeAddon::RunUInt),
-       InstanceMethod("RunInt64", &WasmEdgeAddon::RunInt64),
-       InstanceMethod("RunUInt64", &WasmEdgeAddon::RunUInt64),
-       InstanceMethod("RunString", &WasmEdgeAddon::RunString),
-       InstanceMethod("RunUint8Array", &WasmEdgeAddon::RunUint8Array)});
-
-  Constructor = Napi::Persistent(Func);
-  Constructor.SuppressDestruct();
+       InstanceMethod("RunInt",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunInt, 'i'>),
+       InstanceMethod("RunUInt",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunUInt, 'I'>),
+       InstanceMethod("RunInt64",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunInt64, 'l'>),
+       InstanceMethod("RunUInt64",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunUInt64, 'L'>),
+       InstanceMethod("RunFloat",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunFloat, 'f'>),
+       InstanceMethod("RunDouble",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunDouble, 'd'>),
+       InstanceMethod("RunMulti",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunMulti, 'm'>),
+       InstanceMethod("RunString",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunString, 's'>),
+       InstanceMethod(
+           "RunUint8Array",
+           &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunUint8Array, 'a'>),
+       InstanceMethod("RunValue",
+                      &WasmEdgeAddon::Memoized<&WasmEdgeAddon::RunValue, 'v'>),
+       InstanceMethod("RunPipeline", &WasmEdgeAddon::RunPipeline),
+       InstanceMethod("RunAsync", &WasmEdgeAddon::RunAsync)});
+
+  /// Every worker thread loads the addon into its own napi_env, so the
+  /// constructor reference is kept per env and freed with it.
+  AddonData *Data = new AddonData();
+  Data->Constructor = Napi::Persistent(Func);
+  Env.SetInstanceData(Data);
 
   Exports.Set("VM", Func);
   return Exports;
@@ -38,7 +56,7 @@ Napi::Object WasmEdgeAddon::Init(Napi::Env Env, Napi::Object Exports) {
 
 namespace {
 inline bool checkInputWasmFormat(const Napi::CallbackInfo &Info) {
-  return Info.Length() <= 0 || (!Info[0].IsString() && !Info[0].IsTypedArray());
+  return Info.Length() <= 0 || (!Info[0].IsString() && !Info[0].IsObject());
 }
 
 inline bool isWasiOptionsProvided(const Napi::CallbackInfo &Info) {
@@ -59,6 +77,11 @@ inline uint64_t castFromU32ToU64(uint32_t L, uint32_t H) {
   return static_cast<uint64_t>(L) | (static_cast<uint64_t>(H) << 32);
 }
 
+/// Functions returning a native i64 do not use the wasm-bindgen out-pointer.
+inline bool isNativeInt64(const std::vector<WasmEdge_ValType> &RetTypes) {
+  return RetTypes.size() == 1 && RetTypes[0] == WasmEdge_ValType_I64;
+}
+
 inline bool endsWith(const std::string &S, const std::string &Suffix) {
   return S.length() >= Suffix.length() &&
          S.compare(S.length() - Suffix.length(), std::string::npos, Suffix) ==
@@ -69,7 +92,8 @@ inline bool endsWith(const std::string &S, const std::string &Suffix) {
 
 WasmEdgeAddon::WasmEdgeAddon(const Napi::CallbackInfo &Info)
     : Napi::ObjectWrap<WasmEdgeAddon>(Info), Configure(nullptr), VM(nullptr),
-      MemInst(nullptr), WasiMod(nullptr), Inited(false) {
+      MemInst(nullptr), WasiMod(nullptr), ImageMod(nullptr),
+      TensorflowMod(nullptr), TensorflowLiteMod(nullptr), Inited(false) {
   Napi::Env Env = Info.Env();
   Napi::HandleScope Scope(Env);
 
@@ -94,7 +118,26 @@ WasmEdgeAddon::WasmEdgeAddon(const Napi::CallbackInfo &Info)
           WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::ParseOptionsFailed).c_str());
       return;
     }
+    if (WasiOptions.Has(WASMEDGE::NAPI::kImportsString) &&
+        !ParseImports(Info.Env(),
+                      WasiOptions.Get(WASMEDGE::NAPI::kImportsString))) {
+      return;
+    }
+    if (WasiOptions.Has(WASMEDGE::NAPI::kModulesString) &&
+        !ParseModules(Info.Env(),
+                      WasiOptions.Get(WASMEDGE::NAPI::kModulesString))) {
+      return;
+    }
   }
+  Queue.setCapacity(Options.getMaxQueueLength());
+  if (!Options.getProfileOutput().empty()) {
+    Profiler.setOutput(Options.getProfileOutput());
+    /// Finalizers do not run at exit, write the last samples from here.
+    ProfileHookAdded =
+        napi_add_env_cleanup_hook(Env, FlushProfile, this) == napi_ok;
+  }
+  Memo.configure(Options.getPureFunctions(), Options.getMemoizeCapacity(),
+                 Options.getMemoizeMaxBytes());
 
   // Handle input wasm
   if (Info[0].IsString()) {
@@ -118,6 +161,16 @@ WasmEdgeAddon::WasmEdgeAddon(const Napi::CallbackInfo &Info)
               .c_str());
       return;
     }
+    MemStat.setNativeBytes(MemStat.getNativeBytes() + BC.getDataSize());
+  } else if (auto *Data = Info.Env().GetInstanceData<AddonData>();
+             Info[0].IsObject() && !Data->StreamConstructor.IsEmpty() &&
+             Info[0].As<Napi::Object>().InstanceOf(
+                 Data->StreamConstructor.Value())) {
+    // Bytecode received by VM.fromStream
+    if (!AdoptStream(Info.Env(), *WASMEDGE::NAPI::ModuleStream::Unwrap(
+                                     Info[0].As<Napi::Object>()))) {
+      return;
+    }
   } else {
     napi_throw_error(
         Info.Env(), "Error",
@@ -126,29 +179,23 @@ WasmEdgeAddon::WasmEdgeAddon(const Napi::CallbackInfo &Info)
   }
 }
 
-void WasmEdgeAddon::InitVM(const Napi::CallbackInfo &Info) {
+void WasmEdgeAddon::InitVM(Napi::Env Env) {
   if (Inited) {
     return;
   }
 
-  Configure = WasmEdge_ConfigureCreate();
+  MemStat.beginCall();
+  Configure = WASMEDGE::NAPI::createConfigure();
+  if (Options.getMaxMemoryPages() > 0) {
+    WasmEdge_ConfigureSetMaxMemoryPage(Configure, Options.getMaxMemoryPages());
+  }
   Stat = WasmEdge_StatisticsCreate();
-  WasmEdge_ConfigureAddProposal(Configure,
-                                WasmEdge_Proposal_BulkMemoryOperations);
-  WasmEdge_ConfigureAddProposal(Configure, WasmEdge_Proposal_ReferenceTypes);
-  WasmEdge_ConfigureAddProposal(Configure, WasmEdge_Proposal_SIMD);
   WasmEdge_ConfigureAddHostRegistration(Configure,
                                         WasmEdge_HostRegistration_Wasi);
   WasmEdge_ConfigureAddHostRegistration(
       Configure, WasmEdge_HostRegistration_WasmEdge_Process);
   VM = WasmEdge_VMCreate(Configure, nullptr);
-
-  ImageMod = WasmEdge_Image_ImportObjectCreate();
-  WasmEdge_VMRegisterModuleFromImport(VM, ImageMod);
-  TensorflowMod = WasmEdge_Tensorflow_ImportObjectCreate();
-  WasmEdge_VMRegisterModuleFromImport(VM, TensorflowMod);
-  TensorflowLiteMod = WasmEdge_TensorflowLite_ImportObjectCreate();
-  WasmEdge_VMRegisterModuleFromImport(VM, TensorflowLiteMod);
+  /// The extension host modules are registered when the module is loaded.
 
   WasmEdge_LogSetErrorLevel();
 
@@ -171,7 +218,14 @@ void WasmEdgeAddon::FiniVM() {
     return;
   }
 
+  if (MemInst != nullptr) {
+    MemStat.setLinearMemoryPages(WasmEdge_MemoryInstanceGetPageSize(MemInst));
+  }
+  MemStat.setNativeBytes(BC.getDataSize());
+
   Stat = WasmEdge_VMGetStatisticsContext(VM);
+  WasmEdge_InterpreterDelete(Interp);
+  Interp = nullptr;
   WasmEdge_VMDelete(VM);
   VM = nullptr;
   Store = nullptr;
@@ -185,27 +239,49 @@ void WasmEdgeAddon::FiniVM() {
   TensorflowMod = nullptr;
   WasmEdge_ImportObjectDelete(TensorflowLiteMod);
   TensorflowLiteMod = nullptr;
+  for (auto *Mod : JSImportMods) {
+    WasmEdge_ImportObjectDelete(Mod);
+  }
+  JSImportMods.clear();
+
+  /// Keep the output of the writable memfs trees for GetMemFSFiles.
+  MemFSFiles.clear();
+  for (const auto &Overlay : MemFSOverlays) {
+    WASMEDGE::NAPI::collectMemFSFiles(Overlay.second, Overlay.first,
+                                      MemFSFiles);
+  }
+  RemoveMemFSOverlays();
+
+  /// Deleting the VM unmaps the linear memory. Also hand the freed host heap
+  /// pages (copies of arguments, results and bytecode) back to the OS.
+  if (Options.isReclaimMemory()) {
+    malloc_trim(0);
+  }
 
   Inited = false;
 }
 
-void WasmEdgeAddon::InitWasi(const Napi::CallbackInfo &Info,
-                             const std::string &FuncName) {
+void WasmEdgeAddon::InitWasi(Napi::Env Env, const std::string &FuncName,
+                             bool AllowTrusted) {
   WasiMod =
       WasmEdge_VMGetImportModuleContext(VM, WasmEdge_HostRegistration_Wasi);
 
+  /// Read the function names before the bytecode is replaced by AOT code.
+  if (!Options.getProfileOutput().empty() && !Profiler.hasFunctionNames()) {
+    Profiler.setFunctionNames(WASMEDGE::NAPI::readFunctionNames(BC.getData()));
+  }
+
   /// Origin input can be Bytecode or FilePath
   if (Options.isAOTMode()) {
-    if (BC.isFile() && endsWith(BC.getPath(), ".so")) {
-      // BC is already the compiled filename, do nothing
-    } else if (!BC.isCompiled()) {
-      Compile();
+    Compile(BC, Cache);
+    for (auto &Linked : LinkedModules) {
+      Compile(Linked.BC, Linked.Cache);
     }
     /// After Compile(), {Bytecode, FilePath} -> {FilePath}
   }
 
   if (Options.isReactorMode()) {
-    LoadWasm(Info);
+    LoadWasm(Env, AllowTrusted);
   }
 
   std::vector<const char *> WasiCmdArgs;
@@ -218,145 +294,327 @@ void WasmEdgeAddon::InitWasi(const Napi::CallbackInfo &Info,
   for (auto &env : Options.getWasiEnvs()) {
     WasiEnvs.push_back(env.c_str());
   }
+  /// Every call gets fresh copies of the writable memfs trees.
+  RemoveMemFSOverlays();
+  std::vector<std::string> OverlayDirs;
+  for (const auto &Writable : Options.getMemFSWritable()) {
+    std::string HostPath =
+        WASMEDGE::NAPI::createMemFSOverlay(*Writable.second);
+    if (HostPath.empty()) {
+      napi_throw_error(
+          Env, "Error",
+          WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::MemFSFailed).c_str());
+      return;
+    }
+    MemFSOverlays.emplace_back(Writable.first, HostPath);
+    OverlayDirs.push_back(Writable.first + ":" + HostPath);
+  }
   std::vector<const char *> WasiDirs;
-  WasiDirs.reserve(Options.getWasiDirs().size());
+  WasiDirs.reserve(Options.getWasiDirs().size() + OverlayDirs.size());
   for (auto &dir : Options.getWasiDirs()) {
     WasiDirs.push_back(dir.c_str());
   }
+  for (auto &dir : OverlayDirs) {
+    WasiDirs.push_back(dir.c_str());
+  }
   WasmEdge_ImportObjectInitWASI(WasiMod, WasiCmdArgs.data(), WasiCmdArgs.size(),
                                 WasiEnvs.data(), WasiEnvs.size(),
                                 WasiDirs.data(), WasiDirs.size());
 
   if (Options.isAOTMode()) {
-    InitReactor(Info);
+    InitReactor(Env);
   }
 }
 
 void WasmEdgeAddon::ThrowNapiError(const Napi::CallbackInfo &Info,
                                    ErrorType Type) {
+  ThrowNapiError(Info.Env(), Type);
+}
+
+void WasmEdgeAddon::ThrowNapiError(Napi::Env Env, ErrorType Type) {
   FiniVM();
-  napi_throw_error(Info.Env(), "Error",
-                   WASMEDGE::NAPI::ErrorMsgs.at(Type).c_str());
+  napi_throw_error(Env, "Error", WASMEDGE::NAPI::ErrorMsgs.at(Type).c_str());
 }
 
-bool WasmEdgeAddon::Compile() {
+bool WasmEdgeAddon::Compile(WASMEDGE::NAPI::Bytecode &Code,
+                            WASMEDGE::NAPI::Cache &CodeCache) {
+  if (Code.isFile() && (endsWith(Code.getPath(), ".so") ||
+                        Code.getPath() == CodeCache.getPath())) {
+    // Code is already the compiled filename, do nothing
+    return true;
+  }
+  if (Code.isCompiled()) {
+    return true;
+  }
+
   /// Calculate hash and path.
-  Cache.init(BC.getData());
+  CodeCache.init(Code.getData(), Options.getCompilerOptions());
+
+  /// Other threads of the process compiling the same module wait here and
+  /// then find it in the cache. Other processes wait in compileToCache.
+  const bool Wait = !Options.isInterpretWhileCompiling();
+  auto CompileLock = WASMEDGE::NAPI::ModuleRegistry::instance().compileLock(
+      CodeCache.getPath());
+  std::unique_lock<std::mutex> Lock(*CompileLock, std::defer_lock);
+  if (Wait) {
+    Lock.lock();
+  } else if (!Lock.try_lock()) {
+    /// Code stays the wasm file and runs in the interpreter.
+    Code.setFileMode();
+    return false;
+  }
 
   /// If the compiled bytecode existed, return directly.
-  if (!Cache.isCached()) {
+  if (!CodeCache.isCached()) {
     /// Cache not found. Compile wasm bytecode
-    if (auto Res = CompileBytecodeTo(Cache.getPath()); !Res) {
+    Code.setFileMode();
+    WasmEdge_ConfigureContext *CompilerConf =
+        WASMEDGE::NAPI::createConfigure(Options.getCompilerOptions());
+    WASMEDGE::NAPI::CompileResult Result = {false, 0, "", 0.0, 0};
+    WASMEDGE::NAPI::CacheFillStatus Status = WASMEDGE::NAPI::compileToCache(
+        CompilerConf, Code.getPath(), CodeCache.getPath(), Wait, Result);
+    WasmEdge_ConfigureDelete(CompilerConf);
+    if (Status == WASMEDGE::NAPI::CacheFillStatus::Failed) {
+      std::cerr << "WasmEdge Compile failed. Error: " << Result.ErrorMessage;
+      return false;
+    }
+    if (Status == WASMEDGE::NAPI::CacheFillStatus::Busy) {
       return false;
     }
   }
 
   /// After compiled Bytecode, the output will be written to a FilePath.
-  BC.setPath(Cache.getPath());
+  Code.setPath(CodeCache.getPath());
+  return true;
+}
+
+bool WasmEdgeAddon::CompileBytecodeTo(WASMEDGE::NAPI::Bytecode &Code,
+                                      const std::string &Path) {
+  /// Make sure Code is in FilePath mode
+  Code.setFileMode();
+
+  /// The compiler has its own configure, so this also works before InitVM().
+  WasmEdge_ConfigureContext *CompilerConf =
+      WASMEDGE::NAPI::createConfigure(Options.getCompilerOptions());
+  WASMEDGE::NAPI::CompileResult Result =
+      WASMEDGE::NAPI::compileFile(CompilerConf, Code.getPath(), Path);
+  WasmEdge_ConfigureDelete(CompilerConf);
+  if (!Result.Succeeded) {
+    std::cerr << "WasmEdge Compile failed. Error: " << Result.ErrorMessage;
+    return false;
+  }
   return true;
 }
 
-bool WasmEdgeAddon::CompileBytecodeTo(const std::string &Path) {
-  /// Make sure BC is in FilePath mode
-  BC.setFileMode();
+WasmEdge_Result WasmEdgeAddon::Invoke(const WasmEdge_String FuncName,
+                                      const WasmEdge_Value *Params,
+                                      const uint32_t ParamLen,
+                                      WasmEdge_Value *Rets,
+                                      const uint32_t RetLen) {
+  if (Interp != nullptr) {
+    return WasmEdge_InterpreterInvoke(Interp, Store, FuncName, Params, ParamLen,
+                                      Rets, RetLen);
+  }
+  return WasmEdge_VMExecute(VM, FuncName, Params, ParamLen, Rets, RetLen);
+}
 
-  if (Options.isMeasuring()) {
-    WasmEdge_ConfigureStatisticsSetCostMeasuring(Configure, true);
-    WasmEdge_ConfigureStatisticsSetInstructionCounting(Configure, true);
+WasmEdge_Result WasmEdgeAddon::Execute(const std::string &FuncName,
+                                       const std::vector<WasmEdge_Value> &Args,
+                                       WasmEdge_Value *Rets,
+                                       const uint32_t RetLen) {
+  WasmEdge_String WasmFuncName =
+      WasmEdge_StringCreateByCString(FuncName.c_str());
+  const bool Profiling = !Options.getProfileOutput().empty() &&
+                         Profiler.start(Options.getProfileInterval());
+  if (Options.isPerfCounters()) {
+    PerfCounters.start();
   }
-  WasmEdge_CompilerContext *CompilerCxt = WasmEdge_CompilerCreate(Configure);
   WasmEdge_Result Res =
-      WasmEdge_CompilerCompile(CompilerCxt, BC.getPath().c_str(), Path.c_str());
-  if (!WasmEdge_ResultOK(Res)) {
-    std::cerr << "WasmEdge Compile failed. Error: "
-              << WasmEdge_ResultGetMessage(Res);
-    return false;
+      Invoke(WasmFuncName, Args.data(), Args.size(), Rets, RetLen);
+  if (Options.isPerfCounters()) {
+    PerfCounters.stop();
   }
-  return true;
+  if (Profiling) {
+    Profiler.stop(BC.isFile() ? BC.getPath() : "");
+    Profiler.flush(false);
+  }
+  WasmEdge_StringDelete(WasmFuncName);
+  return Res;
 }
 
 void WasmEdgeAddon::PrepareResource(const Napi::CallbackInfo &Info,
                                     std::vector<WasmEdge_Value> &Args,
                                     IntKind IntT) {
+  std::string FuncName;
+  std::vector<Napi::Value> Values;
+  if (Info.Length() > 0) {
+    FuncName = Info[0].As<Napi::String>().Utf8Value();
+  }
   for (std::size_t I = 1; I < Info.Length(); I++) {
-    Napi::Value Arg = Info[I];
-    uint32_t MallocSize = 0, MallocAddr = 0;
-    if (Arg.IsNumber()) {
+    Values.push_back(Info[I]);
+  }
+  PrepareResource(Info.Env(), FuncName, Values, Args, IntT);
+}
+
+void WasmEdgeAddon::PrepareResource(Napi::Env Env, const std::string &FuncName,
+                                    const std::vector<Napi::Value> &Values,
+                                    std::vector<WasmEdge_Value> &Args,
+                                    IntKind IntT) {
+  std::vector<WasmEdge_ValType> ParamTypes, RetTypes;
+  WASMEDGE::NAPI::getFunctionType(VM, FuncName, ParamTypes, RetTypes);
+  const bool IsNativeInt64 = isNativeInt64(RetTypes);
+
+  for (const Napi::Value &Arg : Values) {
+    if (Arg.IsNumber() || Arg.IsBigInt()) {
       switch (IntT) {
+      case IntKind::SInt64:
+      case IntKind::UInt64:
+        if (!IsNativeInt64) {
+          // Legacy wasm-bindgen ABI: i64 is split into two i32 halves and the
+          // result is written back through an out-pointer.
+          if (Args.size() == 0) {
+            // Set memory offset for return value
+            Args.emplace_back(WasmEdge_ValueGenI32(0));
+          }
+          WasmEdge_Value Val;
+          if (!WASMEDGE::NAPI::toWasmEdgeValue(Arg, WasmEdge_ValType_I64,
+                                               Val)) {
+            napi_throw_error(
+                Env, "Error",
+                WASMEDGE::NAPI::ErrorMsgs
+                    .at(ErrorType::UnsupportedArgumentType)
+                    .c_str());
+            return;
+          }
+          uint64_t V = static_cast<uint64_t>(WasmEdge_ValueGetI64(Val));
+          Args.emplace_back(WasmEdge_ValueGenI32(castFromU64ToU32(V)));
+          Args.emplace_back(WasmEdge_ValueGenI32(castFromU64ToU32(V >> 32)));
+          break;
+        }
+        [[fallthrough]];
       case IntKind::SInt32:
       case IntKind::UInt32:
-      case IntKind::Default:
-        Args.emplace_back(
-            WasmEdge_ValueGenI32(Arg.As<Napi::Number>().Int32Value()));
-        break;
-      case IntKind::SInt64:
-      case IntKind::UInt64: {
-        if (Args.size() == 0) {
-          // Set memory offset for return value
-          Args.emplace_back(WasmEdge_ValueGenI32(0));
+      case IntKind::Default: {
+        // Use the native parameter type of the function if it is known.
+        WasmEdge_ValType Type = WasmEdge_ValType_I32;
+        if (Args.size() < ParamTypes.size()) {
+          Type = ParamTypes[Args.size()];
         }
-        uint64_t V = static_cast<uint64_t>(Arg.As<Napi::Number>().Int64Value());
-        Args.emplace_back(WasmEdge_ValueGenI32(castFromU64ToU32(V)));
-        Args.emplace_back(WasmEdge_ValueGenI32(castFromU64ToU32(V >> 32)));
+        WasmEdge_Value Val;
+        if (!WASMEDGE::NAPI::toWasmEdgeValue(Arg, Type, Val)) {
+          napi_throw_error(
+              Env, "Error",
+              WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::UnsupportedArgumentType)
+                  .c_str());
+          return;
+        }
+        Args.emplace_back(Val);
         break;
       }
       default:
         napi_throw_error(
-            Info.Env(), "Error",
+            Env, "Error",
             WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::NAPIUnkownIntType).c_str());
         return;
       }
       continue;
     } else if (Arg.IsString()) {
       std::string StrArg = Arg.As<Napi::String>().Utf8Value();
-      MallocSize = StrArg.length();
+      if (!CopyToGuest(Env, reinterpret_cast<const uint8_t *>(StrArg.data()),
+                       StrArg.length(), Args)) {
+        return;
+      }
     } else if (Arg.IsTypedArray() &&
                Arg.As<Napi::TypedArray>().TypedArrayType() ==
                    napi_uint8_array) {
-      Napi::ArrayBuffer DataBuffer = Arg.As<Napi::TypedArray>().ArrayBuffer();
-      MallocSize = DataBuffer.ByteLength();
+      /// Only the bytes of the view, which may be a slice of a larger
+      /// buffer (e.g. a pooled Buffer).
+      Napi::Uint8Array View = Arg.As<Napi::Uint8Array>();
+      if (!CopyToGuest(Env, View.Data(), View.ByteLength(), Args)) {
+        return;
+      }
+    } else if (WASMEDGE::NAPI::FileArgument::is(Arg)) {
+      if (!ReadToGuest(Env, Arg.As<Napi::Object>(), Args)) {
+        return;
+      }
     } else {
       // TODO: support other types
       napi_throw_error(
-          Info.Env(), "Error",
+          Env, "Error",
           WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::UnsupportedArgumentType)
               .c_str());
       return;
     }
+  }
+}
 
-    // Malloc
-    WasmEdge_Value Params = WasmEdge_ValueGenI32(MallocSize);
-    WasmEdge_Value Rets;
-    WasmEdge_String FuncName =
-        WasmEdge_StringCreateByCString("__wbindgen_malloc");
-    WasmEdge_Result Res =
-        WasmEdge_VMExecute(VM, FuncName, &Params, 1, &Rets, 1);
-    WasmEdge_StringDelete(FuncName);
-    if (!WasmEdge_ResultOK(Res)) {
-      napi_throw_error(Info.Env(), "Error", WasmEdge_ResultGetMessage(Res));
-      return;
-    }
-    MallocAddr = (uint32_t)WasmEdge_ValueGetI32(Rets);
+bool WasmEdgeAddon::AllocateInGuest(Napi::Env Env, uint32_t Size,
+                                    uint32_t &Addr) {
+  WasmEdge_Value Params = WasmEdge_ValueGenI32(Size);
+  WasmEdge_Value Rets;
+  WasmEdge_String FuncName =
+      WasmEdge_StringCreateByCString("__wbindgen_malloc");
+  WasmEdge_Result Res = Invoke(FuncName, &Params, 1, &Rets, 1);
+  WasmEdge_StringDelete(FuncName);
+  if (!WasmEdge_ResultOK(Res)) {
+    napi_throw_error(Env, "Error", WasmEdge_ResultGetMessage(Res));
+    return false;
+  }
+  Addr = (uint32_t)WasmEdge_ValueGetI32(Rets);
+  return true;
+}
 
-    // Prepare arguments and memory data
-    Args.emplace_back(WasmEdge_ValueGenI32(MallocAddr));
-    Args.emplace_back(WasmEdge_ValueGenI32(MallocSize));
+bool WasmEdgeAddon::CopyToGuest(Napi::Env Env, const uint8_t *Data,
+                                uint32_t Size,
+                                std::vector<WasmEdge_Value> &Args) {
+  // Malloc
+  uint32_t MallocAddr;
+  if (!AllocateInGuest(Env, Size, MallocAddr)) {
+    return false;
+  }
 
-    // Setup memory
-    if (Arg.IsString()) {
-      std::string StrArg = Arg.As<Napi::String>().Utf8Value();
-      std::vector<uint8_t> StrArgVec(StrArg.begin(), StrArg.end());
-      WasmEdge_MemoryInstanceSetData(MemInst, StrArgVec.data(), MallocAddr,
-                                     StrArgVec.size());
-    } else if (Arg.IsTypedArray() &&
-               Arg.As<Napi::TypedArray>().TypedArrayType() ==
-                   napi_uint8_array) {
-      Napi::ArrayBuffer DataBuffer = Arg.As<Napi::TypedArray>().ArrayBuffer();
-      uint8_t *Data = (uint8_t *)DataBuffer.Data();
-      WasmEdge_MemoryInstanceSetData(MemInst, Data, MallocAddr,
-                                     DataBuffer.ByteLength());
+  // Prepare arguments and memory data
+  Args.emplace_back(WasmEdge_ValueGenI32(MallocAddr));
+  Args.emplace_back(WasmEdge_ValueGenI32(Size));
+
+  // Setup memory
+  WasmEdge_MemoryInstanceSetData(MemInst, Data, MallocAddr, Size);
+  MemStat.addCopiedIn(Size);
+  return true;
+}
+
+bool WasmEdgeAddon::ReadToGuest(Napi::Env Env, const Napi::Object &File,
+                                std::vector<WasmEdge_Value> &Args) {
+  WASMEDGE::NAPI::FileArgument Arg;
+  std::string Error;
+  uint32_t MallocAddr = 0;
+  bool Succeeded = Arg.open(File, Error);
+  if (Succeeded) {
+    if (!AllocateInGuest(Env, Arg.getSize(), MallocAddr)) {
+      return false;
+    }
+    /// pread from the page cache straight into the linear memory.
+    uint8_t *Dest =
+        WasmEdge_MemoryInstanceGetPointer(MemInst, MallocAddr, Arg.getSize());
+    if (Arg.getSize() > 0 && Dest == nullptr) {
+      Error = "the guest allocation is out of bounds";
+      Succeeded = false;
+    } else if (Arg.getSize() > 0) {
+      Succeeded = Arg.read(Dest, Error);
     }
   }
+  if (!Succeeded) {
+    std::string Message =
+        WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::FileArgumentFailed) + ": " +
+        Error;
+    napi_throw_error(Env, "Error", Message.c_str());
+    return false;
+  }
+
+  Args.emplace_back(WasmEdge_ValueGenI32(MallocAddr));
+  Args.emplace_back(WasmEdge_ValueGenI32(Arg.getSize()));
+  MemStat.addCopiedIn(Arg.getSize());
+  return true;
 }
 
 void WasmEdgeAddon::PrepareResource(const Napi::CallbackInfo &Info,
@@ -371,8 +629,7 @@ void WasmEdgeAddon::ReleaseResource(const Napi::CallbackInfo &Info,
                               WasmEdge_ValueGenI32(Size)};
   WasmEdge_String WasmFuncName =
       WasmEdge_StringCreateByCString("__wbindgen_free");
-  WasmEdge_Result Res =
-      WasmEdge_VMExecute(VM, WasmFuncName, Params, 2, nullptr, 0);
+  WasmEdge_Result Res = Invoke(WasmFuncName, Params, 2, nullptr, 0);
   WasmEdge_StringDelete(WasmFuncName);
 
   if (!WasmEdge_ResultOK(Res)) {
@@ -384,20 +641,41 @@ void WasmEdgeAddon::ReleaseResource(const Napi::CallbackInfo &Info,
 }
 
 Napi::Value WasmEdgeAddon::RunStart(const Napi::CallbackInfo &Info) {
-  InitVM(Info);
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
 
   std::string FuncName = "_start";
   const std::vector<std::string> &WasiCmdArgs = Options.getWasiCmdArgs();
   Options.getWasiCmdArgs().erase(WasiCmdArgs.begin(), WasiCmdArgs.begin() + 2);
 
-  InitWasi(Info, FuncName);
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
 
   // command mode
   WasmEdge_String WasmFuncName =
       WasmEdge_StringCreateByCString(FuncName.c_str());
   WasmEdge_Value Ret;
-  WasmEdge_Result Res = WasmEdge_VMRunWasmFromFile(
-      VM, BC.getPath().c_str(), WasmFuncName, nullptr, 0, &Ret, 1);
+  WasmEdge_Result Res;
+  if (const WasmEdge_ASTModuleContext *AST = AcquireModule()) {
+    if (!LoadLinkedModules(Info.Env()) ||
+        !RegisterHostModules(Info.Env(), AST) ||
+        !RegisterLinkedModules(Info.Env(), true)) {
+      WasmEdge_StringDelete(WasmFuncName);
+      FiniVM();
+      return Napi::Value();
+    }
+    Res = WasmEdge_VMRunWasmFromASTModule(VM, AST, WasmFuncName, nullptr, 0,
+                                          &Ret, 1);
+  } else {
+    Res = WasmEdge_VMRunWasmFromFile(VM, BC.getPath().c_str(), WasmFuncName,
+                                     nullptr, 0, &Ret, 1);
+  }
   WasmEdge_StringDelete(WasmFuncName);
 
   if (!WasmEdge_ResultOK(Res)) {
@@ -409,15 +687,356 @@ Napi::Value WasmEdgeAddon::RunStart(const Napi::CallbackInfo &Info) {
   return Napi::Number::New(Info.Env(), ErrCode);
 }
 
-void WasmEdgeAddon::InitReactor(const Napi::CallbackInfo &Info) {
+Napi::Value WasmEdgeAddon::RunValue(const Napi::CallbackInfo &Info) {
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
+  std::string FuncName = "";
+  if (Info.Length() > 0) {
+    FuncName = Info[0].As<Napi::String>().Utf8Value();
+  }
+
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
+
+  std::vector<WasmEdge_Value> Args;
+  uint32_t ResultMemAddr = 8;
+  Args.emplace_back(WasmEdge_ValueGenI32(ResultMemAddr));
+  for (std::size_t I = 1; I < Info.Length(); I++) {
+    EncodeBuffer.clear();
+    if (!WASMEDGE::NAPI::encodeMsgPack(Info.Env(), Info[I], EncodeBuffer)) {
+      ThrowNapiError(Info, ErrorType::UnsupportedArgumentType);
+      return Napi::Value();
+    }
+    if (!CopyToGuest(Info.Env(), EncodeBuffer.data(), EncodeBuffer.size(),
+                     Args)) {
+      FiniVM();
+      return Napi::Value();
+    }
+  }
+  WasmEdge_Value Ret;
+  WasmEdge_Result Res = Execute(FuncName, Args, &Ret, 1);
+
+  if (!WasmEdge_ResultOK(Res)) {
+    ThrowNapiError(Info, ErrorType::ExecutionFailed);
+    return Napi::Value();
+  }
+
+  uint8_t ResultMem[8];
+  Res = WasmEdge_MemoryInstanceGetData(MemInst, ResultMem, ResultMemAddr, 8);
+  if (!WasmEdge_ResultOK(Res)) {
+    ThrowNapiError(Info, ErrorType::BadMemoryAccess);
+    return Napi::Value();
+  }
+  uint32_t ResultDataAddr = castFromBytesToU32(ResultMem, 0);
+  uint32_t ResultDataLen = castFromBytesToU32(ResultMem, 4);
+
+  /// Decode in place from the guest memory.
+  const uint8_t *ResultData = WasmEdge_MemoryInstanceGetPointerConst(
+      MemInst, ResultDataAddr, ResultDataLen);
+  if (ResultData == nullptr) {
+    ThrowNapiError(Info, ErrorType::BadMemoryAccess);
+    return Napi::Value();
+  }
+  Napi::Value Result;
+  const bool Decoded = WASMEDGE::NAPI::decodeMsgPack(Info.Env(), ResultData,
+                                                     ResultDataLen, Result);
+  MemStat.addCopiedOut(ResultDataLen);
+  ReleaseResource(Info, ResultDataAddr, ResultDataLen);
+  if (!Decoded) {
+    ThrowNapiError(Info, ErrorType::InvalidResultEncoding);
+    return Napi::Value();
+  }
+
+  FiniVM();
+  return Result;
+}
+
+bool WasmEdgeAddon::CheckIdle(const Napi::CallbackInfo &Info) {
+  if (Busy || InCall) {
+    /// Not ThrowNapiError(), the VM belongs to the running call.
+    napi_throw_error(
+        Info.Env(), "Error",
+        WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InstanceBusy).c_str());
+    return false;
+  }
+  return true;
+}
+
+Napi::Value WasmEdgeAddon::RunAsync(const Napi::CallbackInfo &Info) {
+  using Clock = std::chrono::steady_clock;
+  auto Call = std::make_unique<WASMEDGE::NAPI::PendingCall>(Info.Env());
+  Napi::Promise Promise = Call->Deferred.Promise();
+  if (InCall) {
+    /// Called from a JS import of a synchronous call, which the queue would
+    /// only run after the import returned.
+    Call->Deferred.Reject(
+        Napi::Error::New(Info.Env(),
+                         WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InstanceBusy))
+            .Value());
+    return Promise;
+  }
+  if (Info.Length() == 0 || !Info[0].IsString()) {
+    Call->Deferred.Reject(
+        Napi::Error::New(
+            Info.Env(),
+            WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::UnsupportedArgumentType))
+            .Value());
+    return Promise;
+  }
+
+  /// A trailing plain object holds the call options, unless it is a file
+  /// range argument.
+  std::size_t ArgEnd = Info.Length();
+  if (ArgEnd > 1 && Info[ArgEnd - 1].IsObject() &&
+      !Info[ArgEnd - 1].IsTypedArray() &&
+      !WASMEDGE::NAPI::FileArgument::is(Info[ArgEnd - 1])) {
+    Napi::Object CallOptions = Info[--ArgEnd].As<Napi::Object>();
+    if (CallOptions.Has("signal") && CallOptions.Get("signal").IsObject()) {
+      Call->Signal =
+          Napi::Persistent(CallOptions.Get("signal").As<Napi::Object>());
+    }
+    if (CallOptions.Has("priority")) {
+      Napi::Value Priority = CallOptions.Get("priority");
+      if (!Priority.IsString() ||
+          !WASMEDGE::NAPI::parsePriority(Priority.As<Napi::String>(),
+                                         Call->Class)) {
+        Call->Deferred.Reject(WASMEDGE::NAPI::makeCodedError(
+                                  Info.Env(), ErrorType::InvalidCallOptions,
+                                  "ERR_INVALID_CALL_OPTIONS")
+                                  .Value());
+        return Promise;
+      }
+    }
+    if (CallOptions.Has("deadline")) {
+      /// Milliseconds since the epoch, like Date.now().
+      Napi::Value Deadline = CallOptions.Get("deadline");
+      if (!Deadline.IsNumber() ||
+          std::isnan(Deadline.As<Napi::Number>().DoubleValue())) {
+        Call->Deferred.Reject(WASMEDGE::NAPI::makeCodedError(
+                                  Info.Env(), ErrorType::InvalidCallOptions,
+                                  "ERR_INVALID_CALL_OPTIONS")
+                                  .Value());
+        return Promise;
+      }
+      const double Remaining =
+          Deadline.As<Napi::Number>().DoubleValue() -
+          std::chrono::duration<double, std::milli>(
+              std::chrono::system_clock::now().time_since_epoch())
+              .count();
+      /// Deadlines beyond a year (or Infinity) are treated as none.
+      if (Remaining < 365.0 * 24 * 3600 * 1000) {
+        Call->Deadline =
+            Clock::now() +
+            std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(
+                    std::max(Remaining, 0.0)));
+      }
+    }
+  }
+  Call->FuncName = Info[0].As<Napi::String>().Utf8Value();
+  for (std::size_t I = 1; I < ArgEnd; I++) {
+    Call->Values.push_back(Napi::Persistent(Info[I]));
+  }
+
+  if (Call->isAborted()) {
+    Call->Deferred.Reject(WASMEDGE::NAPI::makeAbortError(Info.Env()).Value());
+  } else if (Call->Deadline <= Clock::now()) {
+    Queue.recordExpired();
+    Call->Deferred.Reject(WASMEDGE::NAPI::makeCodedError(
+                              Info.Env(), ErrorType::DeadlineExceeded,
+                              "ERR_DEADLINE_EXCEEDED")
+                              .Value());
+  } else if (!Busy && Queue.size() == 0) {
+    Queue.recordDispatch();
+    StartAsync(Info.Env(), std::move(Call));
+  } else {
+    WASMEDGE::NAPI::PendingCall *Queued = Call.get();
+    if (!Queue.push(Call, Call->Class, Call->Deadline)) {
+      Call->Deferred.Reject(WASMEDGE::NAPI::makeCodedError(
+                                Info.Env(), ErrorType::QueueFull,
+                                "ERR_QUEUE_FULL")
+                                .Value());
+      return Promise;
+    }
+    /// An aborted call leaves the queue at once instead of holding a slot
+    /// until its turn. The listener is removed whenever the call leaves the
+    /// queue, so `Queued` is never used after it is freed.
+    Napi::Env Env = Info.Env();
+    Queued->watchSignal(Env,
+                        [this, Env, Queued]() { AbortQueued(Env, Queued); });
+    ArmDeadlineTimer(Env);
+  }
+  return Promise;
+}
+
+void WasmEdgeAddon::StartAsync(
+    Napi::Env Env, std::unique_ptr<WASMEDGE::NAPI::PendingCall> Call) {
+  if (Call->isAborted()) {
+    Call->Deferred.Reject(WASMEDGE::NAPI::makeAbortError(Env).Value());
+    return;
+  }
+
+  /// Errors of the setup are thrown as usual, hand them to the promise.
+  auto RejectPending = [&]() {
+    FiniVM();
+    Call->Deferred.Reject(Env.GetAndClearPendingException().Value());
+  };
+
+  InitVM(Env);
+  /// WasmEdge_VMAsyncExecute needs a module instantiated by the VM workflow.
+  InitWasi(Env, Call->FuncName, false);
+  if (Env.IsExceptionPending()) {
+    RejectPending();
+    return;
+  }
+
+  std::vector<WasmEdge_ValType> ParamTypes, RetTypes;
+  if (!WASMEDGE::NAPI::getFunctionType(VM, Call->FuncName, ParamTypes,
+                                       RetTypes)) {
+    ThrowNapiError(Env, ErrorType::ExecutionFailed);
+    RejectPending();
+    return;
+  }
+
+  std::vector<Napi::Value> Values;
+  for (auto &Ref : Call->Values) {
+    Values.push_back(Ref.Value());
+  }
+  std::vector<WasmEdge_Value> Args;
+  PrepareResource(Env, Call->FuncName, Values, Args, IntKind::Default);
+  if (Env.IsExceptionPending()) {
+    RejectPending();
+    return;
+  }
+
+  /// The guest runs on a thread of WasmEdge, a libuv worker waits for it.
+  /// The profiler and the perf counters are bound to the calling thread, so
+  /// unlike Execute() this path is neither sampled nor counted.
+  WasmEdge_String WasmFuncName =
+      WasmEdge_StringCreateByCString(Call->FuncName.c_str());
+  WasmEdge_Async *Async =
+      WasmEdge_VMAsyncExecute(VM, WasmFuncName, Args.data(), Args.size());
+  WasmEdge_StringDelete(WasmFuncName);
+
+  Busy = true;
+  auto *Worker = new WASMEDGE::NAPI::AsyncRunWorker(
+      Env, Value(), Call->Deferred,
+      std::make_shared<WASMEDGE::NAPI::AsyncExecution>(Async),
+      std::move(RetTypes), [this, Env]() {
+        Busy = false;
+        FiniVM();
+        DispatchNext(Env);
+      });
+  if (!Call->Signal.IsEmpty()) {
+    Worker->connectSignal(Call->Signal.Value());
+  }
+  Worker->Queue();
+}
+
+void WasmEdgeAddon::DispatchNext(Napi::Env Env) {
+  std::unique_ptr<WASMEDGE::NAPI::PendingCall> Call;
+  std::vector<std::unique_ptr<WASMEDGE::NAPI::PendingCall>> Expired;
+  /// A call which fails to start leaves the instance idle, try the next one.
+  while (!Busy && Queue.pop(Call, Expired)) {
+    Call->unwatchSignal();
+    StartAsync(Env, std::move(Call));
+  }
+  for (auto &Entry : Expired) {
+    Entry->unwatchSignal();
+    Entry->Deferred.Reject(WASMEDGE::NAPI::makeCodedError(
+                               Env, ErrorType::DeadlineExceeded,
+                               "ERR_DEADLINE_EXCEEDED")
+                               .Value());
+  }
+  ArmDeadlineTimer(Env);
+}
+
+void WasmEdgeAddon::ExpireQueued(Napi::Env Env) {
+  std::vector<std::unique_ptr<WASMEDGE::NAPI::PendingCall>> Expired;
+  Queue.expire(std::chrono::steady_clock::now(), Expired);
+  for (auto &Entry : Expired) {
+    Entry->unwatchSignal();
+    Entry->Deferred.Reject(WASMEDGE::NAPI::makeCodedError(
+                               Env, ErrorType::DeadlineExceeded,
+                               "ERR_DEADLINE_EXCEEDED")
+                               .Value());
+  }
+  ArmDeadlineTimer(Env);
+}
+
+void WasmEdgeAddon::AbortQueued(Napi::Env Env,
+                                const WASMEDGE::NAPI::PendingCall *Target) {
+  std::unique_ptr<WASMEDGE::NAPI::PendingCall> Call;
+  if (!Queue.remove(
+          [Target](const std::unique_ptr<WASMEDGE::NAPI::PendingCall> &Item) {
+            return Item.get() == Target;
+          },
+          Call)) {
+    return;
+  }
+  Call->unwatchSignal();
+  Call->Deferred.Reject(WASMEDGE::NAPI::makeAbortError(Env).Value());
+  ArmDeadlineTimer(Env);
+}
+
+void WasmEdgeAddon::ArmDeadlineTimer(Napi::Env Env) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point Next = Queue.nextDeadline();
+  if (!DeadlineTimer.IsEmpty() && Next == TimerDeadline) {
+    return;
+  }
+  Napi::Object Global = Env.Global();
+  if (!DeadlineTimer.IsEmpty()) {
+    Global.Get("clearTimeout")
+        .As<Napi::Function>()
+        .Call(Global, {DeadlineTimer.Value()});
+    DeadlineTimer.Reset();
+  }
+  TimerDeadline = Next;
+  if (Next == Clock::time_point::max()) {
+    return;
+  }
+  /// The queue only holds calls while another one runs, which keeps the
+  /// instance alive until the timer is cleared or fires.
+  const double Delay = std::max(
+      0.0, std::ceil(std::chrono::duration<double, std::milli>(
+                         Next - Clock::now())
+                         .count()));
+  Napi::Function OnTimeout =
+      Napi::Function::New(Env, [this](const Napi::CallbackInfo &Info) {
+        DeadlineTimer.Reset();
+        ExpireQueued(Info.Env());
+      });
+  Napi::Value Timer =
+      Global.Get("setTimeout")
+          .As<Napi::Function>()
+          .Call(Global, {OnTimeout, Napi::Number::New(Env, Delay)});
+  /// The running call keeps the event loop alive, not the timer.
+  if (Timer.IsObject() && Timer.As<Napi::Object>().Get("unref").IsFunction()) {
+    Timer.As<Napi::Object>()
+        .Get("unref")
+        .As<Napi::Function>()
+        .Call(Timer, {});
+  }
+  DeadlineTimer = Napi::Persistent(Timer);
+}
+
+void WasmEdgeAddon::InitReactor(Napi::Env Env) {
   using namespace std::literals::string_literals;
   WasmEdge_String InitFunc = WasmEdge_StringCreateByCString("_initialize");
 
   bool HasInit = false;
 
-  uint32_t FuncListLen = WasmEdge_VMGetFunctionListLength(VM);
+  WasmEdge_StoreContext *VMStore = WasmEdge_VMGetStoreContext(VM);
+  uint32_t FuncListLen = WasmEdge_StoreListFunctionLength(VMStore);
   WasmEdge_String FuncList[FuncListLen];
-  WasmEdge_VMGetFunctionList(VM, FuncList, nullptr, FuncListLen);
+  WasmEdge_StoreListFunction(VMStore, FuncList, FuncListLen);
   for (std::size_t I = 1; I < FuncListLen; I++) {
     if (WasmEdge_StringIsEqual(FuncList[I], InitFunc)) {
       HasInit = true;
@@ -426,34 +1045,89 @@ void WasmEdgeAddon::InitReactor(const Napi::CallbackInfo &Info) {
 
   if (HasInit) {
     WasmEdge_Value Ret;
-    WasmEdge_Result Res = WasmEdge_VMExecute(VM, InitFunc, nullptr, 0, &Ret, 1);
+    WasmEdge_Result Res = Invoke(InitFunc, nullptr, 0, &Ret, 1);
     if (!WasmEdge_ResultOK(Res)) {
       napi_throw_error(
-          Info.Env(), "Error",
+          Env, "Error",
           WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InitReactorFailed).c_str());
     }
   }
   WasmEdge_StringDelete(InitFunc);
 }
 
+template <Napi::Value (WasmEdgeAddon::*Method)(const Napi::CallbackInfo &),
+          char Tag>
+Napi::Value WasmEdgeAddon::Memoized(const Napi::CallbackInfo &Info) {
+  Napi::Env Env = Info.Env();
+  /// A hit must not answer a call the instance would reject.
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  if (!Memo.isEnabled() || Info.Length() == 0 || !Info[0].IsString()) {
+    return (this->*Method)(Info);
+  }
+  std::string FuncName = Info[0].As<Napi::String>().Utf8Value();
+  if (!Memo.isPure(FuncName)) {
+    return (this->*Method)(Info);
+  }
+  std::string Key(1, Tag);
+  if (!WASMEDGE::NAPI::appendMemoKey(Env, Info[0], Key)) {
+    return (this->*Method)(Info);
+  }
+  for (size_t I = 1; I < Info.Length(); I++) {
+    if (!WASMEDGE::NAPI::appendMemoKey(Env, Info[I], Key)) {
+      return (this->*Method)(Info);
+    }
+  }
+
+  /// A hit neither creates a VM nor touches guest memory.
+  if (const WASMEDGE::NAPI::MemoValue *Hit = Memo.lookup(Key)) {
+    Napi::Value Restored;
+    if (Hit->restore(Env, Restored)) {
+      return Restored;
+    }
+    /// Treat it as a miss and run the call again.
+    if (Env.IsExceptionPending()) {
+      Env.GetAndClearPendingException();
+    }
+    Memo.erase(Key);
+  }
+  Napi::Value Result = (this->*Method)(Info);
+  if (!Result.IsEmpty() && !Env.IsExceptionPending()) {
+    WASMEDGE::NAPI::MemoValue Value;
+    if (Value.capture(Env, Result)) {
+      Memo.insert(std::move(Key), std::move(Value));
+    }
+  }
+  return Result;
+}
+
 void WasmEdgeAddon::Run(const Napi::CallbackInfo &Info) {
-  InitVM(Info);
+  if (!CheckIdle(Info)) {
+    return;
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
 
   std::string FuncName = "";
   if (Info.Length() > 0) {
     FuncName = Info[0].As<Napi::String>().Utf8Value();
   }
 
-  InitWasi(Info, FuncName);
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return;
+  }
 
   std::vector<WasmEdge_Value> Args;
   PrepareResource(Info, Args);
-  WasmEdge_String WasmFuncName =
-      WasmEdge_StringCreateByCString(FuncName.c_str());
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return;
+  }
   WasmEdge_Value Ret;
-  WasmEdge_Result Res =
-      WasmEdge_VMExecute(VM, WasmFuncName, Args.data(), Args.size(), &Ret, 1);
-  WasmEdge_StringDelete(WasmFuncName);
+  WasmEdge_Result Res = Execute(FuncName, Args, &Ret, 1);
 
   if (!WasmEdge_ResultOK(Res)) {
     ThrowNapiError(Info, ErrorType::ExecutionFailed);
@@ -463,32 +1137,50 @@ void WasmEdgeAddon::Run(const Napi::CallbackInfo &Info) {
 }
 
 Napi::Value WasmEdgeAddon::RunCompile(const Napi::CallbackInfo &Info) {
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
   std::string FileName;
   if (Info.Length() > 0) {
     FileName = Info[0].As<Napi::String>().Utf8Value();
   }
 
-  return Napi::Value::From(Info.Env(), CompileBytecodeTo(FileName));
+  return Napi::Value::From(Info.Env(), CompileBytecodeTo(BC, FileName));
 }
 
 Napi::Value WasmEdgeAddon::RunIntImpl(const Napi::CallbackInfo &Info,
                                       IntKind IntT) {
-  InitVM(Info);
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
   std::string FuncName = "";
   if (Info.Length() > 0) {
     FuncName = Info[0].As<Napi::String>().Utf8Value();
   }
 
-  InitWasi(Info, FuncName);
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
+
+  std::vector<WasmEdge_ValType> ParamTypes, RetTypes;
+  if (!WASMEDGE::NAPI::getFunctionType(VM, FuncName, ParamTypes, RetTypes)) {
+    ThrowNapiError(Info, ErrorType::ExecutionFailed);
+    return Napi::Value();
+  }
 
   std::vector<WasmEdge_Value> Args;
   PrepareResource(Info, Args, IntT);
-  WasmEdge_String WasmFuncName =
-      WasmEdge_StringCreateByCString(FuncName.c_str());
-  WasmEdge_Value Ret;
-  WasmEdge_Result Res =
-      WasmEdge_VMExecute(VM, WasmFuncName, Args.data(), Args.size(), &Ret, 1);
-  WasmEdge_StringDelete(WasmFuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
+  WasmEdge_Value Ret;
+  WasmEdge_Result Res = Execute(FuncName, Args, &Ret, 1);
 
   if (WasmEdge_ResultOK(Res)) {
     switch (IntT) {
@@ -499,13 +1191,23 @@ Napi::Value WasmEdgeAddon::RunIntImpl(const Napi::CallbackInfo &Info,
       return Napi::Number::New(Info.Env(), (uint32_t)WasmEdge_ValueGetI32(Ret));
     case IntKind::SInt64:
     case IntKind::UInt64:
+      if (isNativeInt64(RetTypes)) {
+        FiniVM();
+        return WASMEDGE::NAPI::toNapiValue(Info.Env(), Ret,
+                                           IntT == IntKind::UInt64);
+      }
       uint8_t ResultMem[8];
       Res = WasmEdge_MemoryInstanceGetData(MemInst, ResultMem, 0, 8);
       if (WasmEdge_ResultOK(Res)) {
+        MemStat.addCopiedOut(8);
         uint32_t L = castFromBytesToU32(ResultMem, 0);
         uint32_t H = castFromBytesToU32(ResultMem, 4);
         FiniVM();
-        return Napi::Number::New(Info.Env(), castFromU32ToU64(L, H));
+        if (IntT == IntKind::SInt64) {
+          return Napi::BigInt::New(
+              Info.Env(), static_cast<int64_t>(castFromU32ToU64(L, H)));
+        }
+        return Napi::BigInt::New(Info.Env(), castFromU32ToU64(L, H));
       }
       [[fallthrough]];
     default:
@@ -534,25 +1236,135 @@ Napi::Value WasmEdgeAddon::RunUInt64(const Napi::CallbackInfo &Info) {
   return RunIntImpl(Info, IntKind::UInt64);
 }
 
+Napi::Value WasmEdgeAddon::RunFloatImpl(const Napi::CallbackInfo &Info,
+                                        WasmEdge_ValType RetT) {
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
+  std::string FuncName = "";
+  if (Info.Length() > 0) {
+    FuncName = Info[0].As<Napi::String>().Utf8Value();
+  }
+
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
+
+  /// Check the arity up front: an export with no results would leave Ret
+  /// unwritten.
+  std::vector<WasmEdge_ValType> ParamTypes, RetTypes;
+  if (!WASMEDGE::NAPI::getFunctionType(VM, FuncName, ParamTypes, RetTypes)) {
+    ThrowNapiError(Info, ErrorType::ExecutionFailed);
+    return Napi::Value();
+  }
+  if (RetTypes.size() != 1 || RetTypes[0] != RetT) {
+    ThrowNapiError(Info, ErrorType::ReturnTypeMismatch);
+    return Napi::Value();
+  }
+
+  std::vector<WasmEdge_Value> Args;
+  PrepareResource(Info, Args);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
+  WasmEdge_Value Ret;
+  WasmEdge_Result Res = Execute(FuncName, Args, &Ret, 1);
+
+  if (!WasmEdge_ResultOK(Res)) {
+    ThrowNapiError(Info, ErrorType::ExecutionFailed);
+    return Napi::Value();
+  }
+
+  FiniVM();
+  return WASMEDGE::NAPI::toNapiValue(Info.Env(), Ret);
+}
+
+Napi::Value WasmEdgeAddon::RunFloat(const Napi::CallbackInfo &Info) {
+  return RunFloatImpl(Info, WasmEdge_ValType_F32);
+}
+
+Napi::Value WasmEdgeAddon::RunDouble(const Napi::CallbackInfo &Info) {
+  return RunFloatImpl(Info, WasmEdge_ValType_F64);
+}
+
+Napi::Value WasmEdgeAddon::RunMulti(const Napi::CallbackInfo &Info) {
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
+  std::string FuncName = "";
+  if (Info.Length() > 0) {
+    FuncName = Info[0].As<Napi::String>().Utf8Value();
+  }
+
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
+
+  std::vector<WasmEdge_ValType> ParamTypes, RetTypes;
+  if (!WASMEDGE::NAPI::getFunctionType(VM, FuncName, ParamTypes, RetTypes)) {
+    ThrowNapiError(Info, ErrorType::ExecutionFailed);
+    return Napi::Value();
+  }
+
+  std::vector<WasmEdge_Value> Args;
+  PrepareResource(Info, Args);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
+  std::vector<WasmEdge_Value> Rets(RetTypes.size());
+  WasmEdge_Result Res = Execute(FuncName, Args, Rets.data(), Rets.size());
+
+  if (!WasmEdge_ResultOK(Res)) {
+    ThrowNapiError(Info, ErrorType::ExecutionFailed);
+    return Napi::Value();
+  }
+
+  FiniVM();
+  Napi::Array Results = Napi::Array::New(Info.Env(), Rets.size());
+  for (uint32_t I = 0; I < Rets.size(); I++) {
+    Results.Set(I, WASMEDGE::NAPI::toNapiValue(Info.Env(), Rets[I]));
+  }
+  return Results;
+}
+
 Napi::Value WasmEdgeAddon::RunString(const Napi::CallbackInfo &Info) {
-  InitVM(Info);
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
   std::string FuncName = "";
   if (Info.Length() > 0) {
     FuncName = Info[0].As<Napi::String>().Utf8Value();
   }
 
-  InitWasi(Info, FuncName);
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
 
   WasmEdge_Result Res;
   std::vector<WasmEdge_Value> Args;
   uint32_t ResultMemAddr = 8;
   Args.emplace_back(WasmEdge_ValueGenI32(ResultMemAddr));
   PrepareResource(Info, Args);
-  WasmEdge_String WasmFuncName =
-      WasmEdge_StringCreateByCString(FuncName.c_str());
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
   WasmEdge_Value Ret;
-  Res = WasmEdge_VMExecute(VM, WasmFuncName, Args.data(), Args.size(), &Ret, 1);
-  WasmEdge_StringDelete(WasmFuncName);
+  Res = Execute(FuncName, Args, &Ret, 1);
 
   if (!WasmEdge_ResultOK(Res)) {
     ThrowNapiError(Info, ErrorType::ExecutionFailed);
@@ -577,6 +1389,7 @@ Napi::Value WasmEdgeAddon::RunString(const Napi::CallbackInfo &Info) {
   Res = WasmEdge_MemoryInstanceGetData(MemInst, ResultData.data(),
                                        ResultDataAddr, ResultDataLen);
   if (WasmEdge_ResultOK(Res)) {
+    MemStat.addCopiedOut(ResultDataLen);
     ReleaseResource(Info, ResultDataAddr, ResultDataLen);
   } else {
     ThrowNapiError(Info, ErrorType::BadMemoryAccess);
@@ -589,64 +1402,378 @@ Napi::Value WasmEdgeAddon::RunString(const Napi::CallbackInfo &Info) {
 }
 
 Napi::Value WasmEdgeAddon::RunUint8Array(const Napi::CallbackInfo &Info) {
-  InitVM(Info);
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  InitVM(Info.Env());
   std::string FuncName = "";
   if (Info.Length() > 0) {
     FuncName = Info[0].As<Napi::String>().Utf8Value();
   }
 
-  InitWasi(Info, FuncName);
+  InitWasi(Info.Env(), FuncName);
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
 
   WasmEdge_Result Res;
   std::vector<WasmEdge_Value> Args;
   uint32_t ResultMemAddr = 8;
   Args.emplace_back(WasmEdge_ValueGenI32(ResultMemAddr));
   PrepareResource(Info, Args);
-  WasmEdge_String WasmFuncName =
-      WasmEdge_StringCreateByCString(FuncName.c_str());
+  if (Info.Env().IsExceptionPending()) {
+    FiniVM();
+    return Napi::Value();
+  }
   WasmEdge_Value Ret;
-  Res = WasmEdge_VMExecute(VM, WasmFuncName, Args.data(), Args.size(), &Ret, 1);
-  WasmEdge_StringDelete(WasmFuncName);
+  Res = Execute(FuncName, Args, &Ret, 1);
 
   if (!WasmEdge_ResultOK(Res)) {
     ThrowNapiError(Info, ErrorType::ExecutionFailed);
     return Napi::Value();
   }
 
-  uint8_t ResultMem[8];
-  Res = WasmEdge_MemoryInstanceGetData(MemInst, ResultMem, ResultMemAddr, 8);
   uint32_t ResultDataAddr = 0;
   uint32_t ResultDataLen = 0;
-  if (WasmEdge_ResultOK(Res)) {
-    ResultDataAddr = ResultMem[0] | (ResultMem[1] << 8) | (ResultMem[2] << 16) |
-                     (ResultMem[3] << 24);
-    ResultDataLen = ResultMem[4] | (ResultMem[5] << 8) | (ResultMem[6] << 16) |
-                    (ResultMem[7] << 24);
-  } else {
+  if (!ReadResultRegion(ResultMemAddr, ResultDataAddr, ResultDataLen)) {
     ThrowNapiError(Info, ErrorType::BadMemoryAccess);
     return Napi::Value();
   }
 
-  std::vector<uint8_t> ResultData(ResultDataLen);
-  Res = WasmEdge_MemoryInstanceGetData(MemInst, ResultData.data(),
-                                       ResultDataAddr, ResultDataLen);
+  Napi::Value ResultTypedArray =
+      CopyResultOut(Info, ResultDataAddr, ResultDataLen);
+  if (ResultTypedArray.IsEmpty()) {
+    return ResultTypedArray;
+  }
+  FiniVM();
+  return ResultTypedArray;
+}
+
+bool WasmEdgeAddon::ReadResultRegion(uint32_t RetAddr, uint32_t &Addr,
+                                     uint32_t &Len) {
+  uint8_t ResultMem[8];
+  WasmEdge_Result Res =
+      WasmEdge_MemoryInstanceGetData(MemInst, ResultMem, RetAddr, 8);
+  if (!WasmEdge_ResultOK(Res)) {
+    return false;
+  }
+  Addr = castFromBytesToU32(ResultMem, 0);
+  Len = castFromBytesToU32(ResultMem, 4);
+  return true;
+}
+
+Napi::Value WasmEdgeAddon::CopyResultOut(const Napi::CallbackInfo &Info,
+                                         uint32_t Addr, uint32_t Len) {
+  /// Copy the result straight into a JS owned buffer.
+  Napi::ArrayBuffer ResultArrayBuffer = Napi::ArrayBuffer::New(Info.Env(), Len);
+  WasmEdge_Result Res = WasmEdge_MemoryInstanceGetData(
+      MemInst, static_cast<uint8_t *>(ResultArrayBuffer.Data()), Addr, Len);
   if (WasmEdge_ResultOK(Res)) {
-    ReleaseResource(Info, ResultDataAddr, ResultDataLen);
+    MemStat.addCopiedOut(Len);
+    ReleaseResource(Info, Addr, Len);
   } else {
     ThrowNapiError(Info, ErrorType::BadMemoryAccess);
     return Napi::Value();
   }
 
-  Napi::ArrayBuffer ResultArrayBuffer =
-      Napi::ArrayBuffer::New(Info.Env(), &(ResultData[0]), ResultDataLen);
-  Napi::Uint8Array ResultTypedArray = Napi::Uint8Array::New(
-      Info.Env(), ResultDataLen, ResultArrayBuffer, 0, napi_uint8_array);
-  FiniVM();
-  return ResultTypedArray;
+  return Napi::Uint8Array::New(Info.Env(), Len, ResultArrayBuffer, 0,
+                               napi_uint8_array);
 }
 
-void WasmEdgeAddon::LoadWasm(const Napi::CallbackInfo &Info) {
-  Napi::Env Env = Info.Env();
+Napi::Value WasmEdgeAddon::RunPipeline(const Napi::CallbackInfo &Info) {
+  if (!CheckIdle(Info)) {
+    return Napi::Value();
+  }
+  InCallScope Scope(InCall);
+  /// Every stage is [function_name, args...].
+  std::vector<std::pair<std::string, std::vector<Napi::Value>>> Stages;
+  if (Info.Length() > 0 && Info[0].IsArray()) {
+    Napi::Array StageList = Info[0].As<Napi::Array>();
+    for (uint32_t I = 0; I < StageList.Length(); I++) {
+      Napi::Value Stage = StageList.Get(I);
+      if (!Stage.IsArray() || Stage.As<Napi::Array>().Length() == 0 ||
+          !Stage.As<Napi::Array>().Get(uint32_t(0)).IsString()) {
+        Stages.clear();
+        break;
+      }
+      Napi::Array Items = Stage.As<Napi::Array>();
+      std::vector<Napi::Value> Values;
+      for (uint32_t J = 1; J < Items.Length(); J++) {
+        Values.push_back(Items.Get(J));
+      }
+      Stages.emplace_back(
+          Items.Get(uint32_t(0)).As<Napi::String>().Utf8Value(),
+          std::move(Values));
+    }
+  }
+  if (Stages.empty()) {
+    napi_throw_error(
+        Info.Env(), "Error",
+        WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InvalidPipeline).c_str());
+    return Napi::Value();
+  }
+
+  InitVM(Info.Env());
+  /// Every return from here on, the error paths included, tears the VM down.
+  struct FiniScope {
+    WasmEdgeAddon &Addon;
+    ~FiniScope() { Addon.FiniVM(); }
+  } Fini{*this};
+  InitWasi(Info.Env(), Stages.front().first);
+  if (Info.Env().IsExceptionPending()) {
+    return Napi::Value();
+  }
+
+  const uint32_t ResultMemAddr = 8;
+  uint32_t ResultDataAddr = 0;
+  uint32_t ResultDataLen = 0;
+  for (size_t I = 0; I < Stages.size(); I++) {
+    std::vector<WasmEdge_Value> Args;
+    Args.emplace_back(WasmEdge_ValueGenI32(ResultMemAddr));
+    if (I > 0) {
+      /// The result of the previous stage stays in guest memory and is handed
+      /// over like a Uint8Array argument.
+      Args.emplace_back(WasmEdge_ValueGenI32(ResultDataAddr));
+      Args.emplace_back(WasmEdge_ValueGenI32(ResultDataLen));
+    }
+    PrepareResource(Info.Env(), Stages[I].first, Stages[I].second, Args,
+                    IntKind::Default);
+    if (Info.Env().IsExceptionPending()) {
+      return Napi::Value();
+    }
+    WasmEdge_Value Ret;
+    WasmEdge_Result Res = Execute(Stages[I].first, Args, &Ret, 1);
+    if (!WasmEdge_ResultOK(Res)) {
+      ThrowNapiError(Info, ErrorType::ExecutionFailed);
+      return Napi::Value();
+    }
+    if (!ReadResultRegion(ResultMemAddr, ResultDataAddr, ResultDataLen)) {
+      ThrowNapiError(Info, ErrorType::BadMemoryAccess);
+      return Napi::Value();
+    }
+  }
+
+  /// Only the result of the last stage leaves the guest.
+  Napi::Value Result = CopyResultOut(Info, ResultDataAddr, ResultDataLen);
+  if (Info.Env().IsExceptionPending()) {
+    /// Also a failed __wbindgen_free after the copy.
+    return Napi::Value();
+  }
+  return Result;
+}
+
+const WasmEdge_ASTModuleContext *WasmEdgeAddon::AcquireModule() {
+  /// Parsed modules and loaded AOT libraries are shared by all VMs of the
+  /// process through the registry. Files are looked up again on every call
+  /// so that a rewritten artifact is picked up.
+  auto &Registry = WASMEDGE::NAPI::ModuleRegistry::instance();
+  if (BC.isFile()) {
+    Module = Registry.loadFile(BC.getPath());
+  } else if (!Module && BC.isValidData()) {
+    Module = Registry.loadBuffer(BC.getData());
+  }
+  return Module ? Module->get() : nullptr;
+}
+
+bool WasmEdgeAddon::RegisterHostModules(Napi::Env Env,
+                                       const WasmEdge_ASTModuleContext *AST) {
+  using WASMEDGE::NAPI::Extension;
+  /// Linked modules are instantiated into the same store, so their imports
+  /// are resolved from the same host modules.
+  std::vector<const WasmEdge_ASTModuleContext *> ASTs = {AST};
+  for (const auto &Linked : LinkedModules) {
+    ASTs.push_back(Linked.Module->get());
+  }
+  for (Extension Ext : WASMEDGE::NAPI::requiredExtensions(ASTs)) {
+    std::string Error;
+    WasmEdge_ImportObjectContext *Import =
+        WASMEDGE::NAPI::createExtensionImport(Ext, Error);
+    if (Import == nullptr) {
+      std::string Message =
+          WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::ExtensionLoadFailed) + ": " +
+          Error;
+      napi_throw_error(Env, "Error", Message.c_str());
+      return false;
+    }
+    switch (Ext) {
+    case Extension::Image:
+      ImageMod = Import;
+      break;
+    case Extension::Tensorflow:
+      TensorflowMod = Import;
+      break;
+    case Extension::TensorflowLite:
+      TensorflowLiteMod = Import;
+      break;
+    }
+    WasmEdge_VMRegisterModuleFromImport(VM, Import);
+  }
+  for (auto &JSImport : JSImports) {
+    if (auto *Import = JSImport->createImport(ASTs)) {
+      JSImportMods.push_back(Import);
+      WasmEdge_VMRegisterModuleFromImport(VM, Import);
+    }
+  }
+  return true;
+}
+
+bool WasmEdgeAddon::LoadLinkedModules(Napi::Env Env) {
+  auto &Registry = WASMEDGE::NAPI::ModuleRegistry::instance();
+  for (auto &Linked : LinkedModules) {
+    if (Linked.BC.isCompiled()) {
+      Linked.Cache.dumpToFile(Linked.BC.getData());
+      Linked.BC.setPath(Linked.Cache.getPath());
+    }
+    /// Shared with every VM of the process linking the same module.
+    if (Linked.BC.isFile()) {
+      Linked.Module = Registry.loadFile(Linked.BC.getPath());
+    } else if (!Linked.Module && Linked.BC.isValidData()) {
+      Linked.Module = Registry.loadBuffer(Linked.BC.getData());
+    }
+    if (!Linked.Module) {
+      std::string Message =
+          WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::LinkModuleFailed) + ": " +
+          Linked.Name;
+      napi_throw_error(Env, "Error", Message.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WasmEdgeAddon::RegisterLinkedModules(Napi::Env Env, bool AllowTrusted) {
+  auto &Validated = WASMEDGE::NAPI::ValidationRecord::instance();
+  WasmEdge_StoreContext *VMStore = WasmEdge_VMGetStoreContext(VM);
+  for (auto &Linked : LinkedModules) {
+    WasmEdge_Result Res;
+    WasmEdge_String Name = WasmEdge_StringCreateByCString(Linked.Name.c_str());
+    if (AllowTrusted && Options.isTrustValidated() &&
+        Validated.isValidated(Linked.Module->getDigest())) {
+      WasmEdge_InterpreterContext *Linker = WasmEdge_InterpreterCreate(
+          Configure, WasmEdge_VMGetStatisticsContext(VM));
+      Res = WasmEdge_InterpreterRegisterModule(Linker, VMStore,
+                                               Linked.Module->get(), Name);
+      WasmEdge_InterpreterDelete(Linker);
+    } else {
+      Res = WasmEdge_VMRegisterModuleFromASTModule(VM, Name,
+                                                   Linked.Module->get());
+      if (WasmEdge_ResultOK(Res)) {
+        Validated.recordValidated(Linked.Module->getDigest());
+      }
+    }
+    WasmEdge_StringDelete(Name);
+    if (!WasmEdge_ResultOK(Res)) {
+      std::string Message =
+          WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::LinkModuleFailed) + ": " +
+          Linked.Name;
+      napi_throw_error(Env, "Error", Message.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WasmEdgeAddon::ParseImports(Napi::Env Env, const Napi::Value &Imports) {
+  if (!Imports.IsObject()) {
+    napi_throw_error(
+        Env, "Error",
+        WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InvalidImports).c_str());
+    return false;
+  }
+  auto *Data = Env.GetInstanceData<AddonData>();
+  Napi::Object Modules = Imports.As<Napi::Object>();
+  Napi::Array Names = Modules.GetPropertyNames();
+  for (uint32_t I = 0; I < Names.Length(); I++) {
+    Napi::Value Functions = Modules.Get(Names.Get(I));
+    if (!Functions.IsObject()) {
+      napi_throw_error(
+          Env, "Error",
+          WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InvalidImports).c_str());
+      return false;
+    }
+    if (!Data->Trampoline) {
+      Data->Trampoline =
+          std::make_unique<WASMEDGE::NAPI::HostCallTrampoline>(Env);
+    }
+    JSImports.push_back(std::make_unique<WASMEDGE::NAPI::JSImportModule>(
+        Env, Names.Get(I).ToString().Utf8Value(),
+        Functions.As<Napi::Object>(), *Data->Trampoline));
+  }
+  return true;
+}
+
+bool WasmEdgeAddon::ParseModules(Napi::Env Env, const Napi::Value &Modules) {
+  if (!Modules.IsObject()) {
+    napi_throw_error(
+        Env, "Error",
+        WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InvalidModules).c_str());
+    return false;
+  }
+  Napi::Object Object = Modules.As<Napi::Object>();
+  Napi::Array Names = Object.GetPropertyNames();
+  for (uint32_t I = 0; I < Names.Length(); I++) {
+    Napi::Value Value = Object.Get(Names.Get(I));
+    WASMEDGE::NAPI::LinkedModule Linked;
+    Linked.Name = Names.Get(I).ToString().Utf8Value();
+    if (Value.IsString()) {
+      Linked.BC.setPath(Value.As<Napi::String>().Utf8Value());
+    } else if (Value.IsTypedArray() &&
+               Value.As<Napi::TypedArray>().TypedArrayType() ==
+                   napi_uint8_array) {
+      Napi::Uint8Array Array = Value.As<Napi::Uint8Array>();
+      Linked.BC.setData(std::vector<uint8_t>(
+          Array.Data(), Array.Data() + Array.ByteLength()));
+      if (!Linked.BC.isValidData()) {
+        napi_throw_error(
+            Env, "Error",
+            WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::UnknownBytecodeFormat)
+                .c_str());
+        return false;
+      }
+      MemStat.setNativeBytes(MemStat.getNativeBytes() +
+                             Linked.BC.getDataSize());
+    } else {
+      napi_throw_error(
+          Env, "Error",
+          WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::InvalidModules).c_str());
+      return false;
+    }
+    LinkedModules.push_back(std::move(Linked));
+  }
+  return true;
+}
+
+bool WasmEdgeAddon::AdoptStream(Napi::Env Env,
+                                WASMEDGE::NAPI::ModuleStream &Stream) {
+  if (!Stream.isReady()) {
+    napi_throw_error(
+        Env, "Error",
+        WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::ModuleStreamNotReady).c_str());
+    return false;
+  }
+  if (!Stream.getCachePath().empty()) {
+    /// The AoT artifact was found and loaded while the stream ended.
+    Cache.init(Stream.getHash(), Stream.getCompilerOptions());
+    BC.setPath(Stream.getCachePath());
+    Stream.takeData();
+  } else {
+    BC.setData(Stream.takeData());
+    if (!BC.isValidData()) {
+      napi_throw_error(
+          Env, "Error",
+          WASMEDGE::NAPI::ErrorMsgs.at(ErrorType::UnknownBytecodeFormat)
+              .c_str());
+      return false;
+    }
+    MemStat.setNativeBytes(MemStat.getNativeBytes() + BC.getDataSize());
+  }
+  Module = Stream.takeModule();
+  return true;
+}
+
+void WasmEdgeAddon::LoadWasm(Napi::Env Env, bool AllowTrusted) {
   Napi::HandleScope Scope(Env);
 
   if (BC.isCompiled()) {
@@ -654,42 +1781,88 @@ void WasmEdgeAddon::LoadWasm(const Napi::CallbackInfo &Info) {
     BC.setPath(Cache.getPath());
   }
 
-  WasmEdge_Result Res;
-  if (BC.isFile()) {
-    Res = WasmEdge_VMLoadWasmFromFile(VM, BC.getPath().c_str());
-    if (!WasmEdge_ResultOK(Res)) {
-      ThrowNapiError(Info, ErrorType::LoadWasmFailed);
+  const WasmEdge_ASTModuleContext *AST = AcquireModule();
+  if (AST == nullptr) {
+    ThrowNapiError(Env, ErrorType::LoadWasmFailed);
+    return;
+  }
+  if (!LoadLinkedModules(Env) || !RegisterHostModules(Env, AST) ||
+      !RegisterLinkedModules(Env, AllowTrusted)) {
+    FiniVM();
+    return;
+  }
+
+  auto &Validated = WASMEDGE::NAPI::ValidationRecord::instance();
+  Store = WasmEdge_VMGetStoreContext(VM);
+  if (AllowTrusted && Options.isTrustValidated() &&
+      Validated.isValidated(Module->getDigest())) {
+    if (!InstantiateTrusted(*Module)) {
+      ThrowNapiError(Env, ErrorType::InstantiateWasmFailed);
       return;
     }
-  } else if (BC.isValidData()) {
-    Res = WasmEdge_VMLoadWasmFromBuffer(VM, BC.getData().data(),
-                                        BC.getData().size());
+  } else {
+    WasmEdge_Result Res = WasmEdge_VMLoadWasmFromASTModule(VM, AST);
     if (!WasmEdge_ResultOK(Res)) {
-      ThrowNapiError(Info, ErrorType::LoadWasmFailed);
+      ThrowNapiError(Env, ErrorType::LoadWasmFailed);
       return;
     }
-  }
 
-  Res = WasmEdge_VMValidate(VM);
-  if (!WasmEdge_ResultOK(Res)) {
-    ThrowNapiError(Info, ErrorType::ValidateWasmFailed);
-    return;
-  }
+    Res = WasmEdge_VMValidate(VM);
+    if (!WasmEdge_ResultOK(Res)) {
+      ThrowNapiError(Env, ErrorType::ValidateWasmFailed);
+      return;
+    }
+    Validated.recordValidated(Module->getDigest());
 
-  Res = WasmEdge_VMInstantiate(VM);
-  if (!WasmEdge_ResultOK(Res)) {
-    ThrowNapiError(Info, ErrorType::InstantiateWasmFailed);
-    return;
+    Res = WasmEdge_VMInstantiate(VM);
+    if (!WasmEdge_ResultOK(Res)) {
+      ThrowNapiError(Env, ErrorType::InstantiateWasmFailed);
+      return;
+    }
   }
 
   // Get memory instance
-  Store = WasmEdge_VMGetStoreContext(VM);
   uint32_t MemLen = WasmEdge_StoreListMemoryLength(Store);
   WasmEdge_String MemNames[MemLen];
   WasmEdge_StoreListMemory(Store, MemNames, MemLen);
   MemInst = WasmEdge_StoreFindMemory(Store, MemNames[0]);
 }
 
+bool WasmEdgeAddon::InstantiateTrusted(
+    const WASMEDGE::NAPI::SharedModule &Shared) {
+  /// The VM always validates before it instantiates. Instantiate the shared
+  /// AST into the store of the VM directly instead, where the host modules
+  /// of the VM are already registered. Statistics go to the VM's context.
+  Interp =
+      WasmEdge_InterpreterCreate(Configure, WasmEdge_VMGetStatisticsContext(VM));
+  WasmEdge_Result Res =
+      WasmEdge_InterpreterInstantiate(Interp, Store, Shared.get());
+  return WasmEdge_ResultOK(Res);
+}
+
+void WasmEdgeAddon::RemoveMemFSOverlays() {
+  for (const auto &Overlay : MemFSOverlays) {
+    WASMEDGE::NAPI::removeMemFSTree(Overlay.second);
+  }
+  MemFSOverlays.clear();
+}
+
+Napi::Value WasmEdgeAddon::GetMemFSFiles(const Napi::CallbackInfo &Info) {
+  Napi::Object Files = Napi::Object::New(Info.Env());
+  for (auto &File : MemFSFiles) {
+    /// Hand the buffer over to JS instead of copying it.
+    auto *Data = new std::vector<uint8_t>(std::move(File.second));
+    Napi::ArrayBuffer Buffer = Napi::ArrayBuffer::New(
+        Info.Env(), Data->data(), Data->size(),
+        [](Napi::Env, void *, std::vector<uint8_t> *Hint) { delete Hint; },
+        Data);
+    Files.Set(File.first,
+              Napi::Uint8Array::New(Info.Env(), Data->size(), Buffer, 0));
+  }
+  MemFSFiles.clear();
+  return Files;
+}
+
 Napi::Value WasmEdgeAddon::GetStatistics(const Napi::CallbackInfo &Info) {
   Napi::Object RetStat = Napi::Object::New(Info.Env());
   if (!Options.isMeasuring()) {
@@ -707,5 +1880,137 @@ Napi::Value WasmEdgeAddon::GetStatistics(const Napi::CallbackInfo &Info) {
                                   WasmEdge_StatisticsGetInstrPerSecond(Stat)));
   }
 
+  uint64_t ArtifactSize = 0;
+  if (Options.isAOTMode() && BC.isFile()) {
+    std::error_code EC;
+    ArtifactSize = std::filesystem::file_size(BC.getPath(), EC);
+    if (EC) {
+      ArtifactSize = 0;
+    }
+  }
+  Napi::Object Memory = Napi::Object::New(Info.Env());
+  Memory.Set("LinearMemoryPages",
+             Napi::Number::New(Info.Env(), MemStat.getLinearMemoryPages()));
+  Memory.Set("PeakLinearMemoryPages",
+             Napi::Number::New(Info.Env(), MemStat.getPeakLinearMemoryPages()));
+  Memory.Set("BytesCopiedIn",
+             Napi::Number::New(Info.Env(), MemStat.getLastCopiedIn()));
+  Memory.Set("BytesCopiedOut",
+             Napi::Number::New(Info.Env(), MemStat.getLastCopiedOut()));
+  Memory.Set("TotalBytesCopiedIn",
+             Napi::Number::New(Info.Env(), MemStat.getTotalCopiedIn()));
+  Memory.Set("TotalBytesCopiedOut",
+             Napi::Number::New(Info.Env(), MemStat.getTotalCopiedOut()));
+  Memory.Set("BytecodeSize", Napi::Number::New(Info.Env(), BC.getDataSize()));
+  Memory.Set("AOTArtifactSize", Napi::Number::New(Info.Env(), ArtifactSize));
+  Memory.Set("NativeBytes",
+             Napi::Number::New(Info.Env(), MemStat.getNativeBytes()));
+  RetStat.Set("Memory", Memory);
+
+  if (!Options.getProfileOutput().empty()) {
+    Napi::Object Profile = Napi::Object::New(Info.Env());
+    Profile.Set("Output",
+                Napi::String::New(Info.Env(), Options.getProfileOutput()));
+    Profile.Set("Samples",
+                Napi::Number::New(Info.Env(), Profiler.getSampleCount()));
+    Profile.Set("DroppedSamples",
+                Napi::Number::New(Info.Env(), Profiler.getDroppedCount()));
+    RetStat.Set("Profile", Profile);
+  }
+
+  if (Options.isPerfCounters()) {
+    using PerfEvent = WASMEDGE::NAPI::PerfCounters::Event;
+    Napi::Object Counters = Napi::Object::New(Info.Env());
+    Napi::Object Last = Napi::Object::New(Info.Env());
+    Napi::Object Total = Napi::Object::New(Info.Env());
+    for (uint32_t I = 0; I < WASMEDGE::NAPI::PerfCounters::kNumEvents; I++) {
+      const PerfEvent E = static_cast<PerfEvent>(I);
+      const char *Name = WASMEDGE::NAPI::PerfCounters::kEventNames[I];
+      if (PerfCounters.isAvailable(E)) {
+        Last.Set(Name, Napi::Number::New(Info.Env(), PerfCounters.getLast(E)));
+        Total.Set(Name,
+                  Napi::Number::New(Info.Env(), PerfCounters.getTotal(E)));
+      } else {
+        Last.Set(Name, Info.Env().Null());
+        Total.Set(Name, Info.Env().Null());
+      }
+    }
+    Counters.Set("Calls",
+                 Napi::Number::New(Info.Env(), PerfCounters.getCalls()));
+    Counters.Set("Last", Last);
+    Counters.Set("Total", Total);
+    if (!PerfCounters.getError().empty()) {
+      Counters.Set("Error",
+                   Napi::String::New(Info.Env(), PerfCounters.getError()));
+    }
+    RetStat.Set("PerfCounters", Counters);
+  }
+
+  const WASMEDGE::NAPI::ProcessMemoryStatistics &Process =
+      WASMEDGE::NAPI::processMemoryStatistics();
+  Napi::Object ProcessMemory = Napi::Object::New(Info.Env());
+  ProcessMemory.Set("Instances",
+                    Napi::Number::New(Info.Env(), Process.Instances));
+  ProcessMemory.Set("LinearMemoryPages",
+                    Napi::Number::New(Info.Env(), Process.LinearMemoryPages));
+  ProcessMemory.Set(
+      "PeakLinearMemoryPages",
+      Napi::Number::New(Info.Env(), Process.PeakLinearMemoryPages));
+  ProcessMemory.Set("TotalBytesCopiedIn",
+                    Napi::Number::New(Info.Env(), Process.BytesCopiedIn));
+  ProcessMemory.Set("TotalBytesCopiedOut",
+                    Napi::Number::New(Info.Env(), Process.BytesCopiedOut));
+  ProcessMemory.Set("NativeBytes",
+                    Napi::Number::New(Info.Env(), Process.NativeBytes));
+  RetStat.Set("ProcessMemory", ProcessMemory);
+
+  const WASMEDGE::NAPI::SchedulerStatistics &Sched = Queue.getStatistics();
+  Napi::Object Scheduler = Napi::Object::New(Info.Env());
+  Scheduler.Set("QueueLength", Napi::Number::New(Info.Env(), Queue.size()));
+  Scheduler.Set("MaxQueueLength",
+                Napi::Number::New(Info.Env(), Queue.getCapacity()));
+  Scheduler.Set("Dispatched", Napi::Number::New(Info.Env(), Sched.Dispatched));
+  Scheduler.Set("RejectedQueueFull",
+                Napi::Number::New(Info.Env(), Sched.RejectedFull));
+  Scheduler.Set("Expired", Napi::Number::New(Info.Env(), Sched.Expired));
+  Scheduler.Set("LastQueueWait", Napi::Number::New(Info.Env(), Sched.LastWait));
+  Scheduler.Set("AverageQueueWait",
+                Napi::Number::New(Info.Env(),
+                                  Sched.Dispatched == 0
+                                      ? 0.0
+                                      : Sched.TotalWait / Sched.Dispatched));
+  Scheduler.Set("MaxQueueWait", Napi::Number::New(Info.Env(), Sched.MaxWait));
+  RetStat.Set("Scheduler", Scheduler);
+
+  if (Memo.isEnabled()) {
+    Napi::Object Memoize = Napi::Object::New(Info.Env());
+    Memoize.Set("Hits", Napi::Number::New(Info.Env(), Memo.getHits()));
+    Memoize.Set("Misses", Napi::Number::New(Info.Env(), Memo.getMisses()));
+    Memoize.Set("Entries", Napi::Number::New(Info.Env(), Memo.getEntries()));
+    Memoize.Set("Bytes", Napi::Number::New(Info.Env(), Memo.getBytes()));
+    Memoize.Set("Evictions",
+                Napi::Number::New(Info.Env(), Memo.getEvictions()));
+    RetStat.Set("Memoize", Memoize);
+  }
+
+  auto &Registry = WASMEDGE::NAPI::ModuleRegistry::instance();
+  Napi::Object SharedModules = Napi::Object::New(Info.Env());
+  SharedModules.Set("Modules",
+                    Napi::Number::New(Info.Env(), Registry.getModuleCount()));
+  SharedModules.Set("Hits", Napi::Number::New(Info.Env(), Registry.getHits()));
+  SharedModules.Set("Misses",
+                    Napi::Number::New(Info.Env(), Registry.getMisses()));
+  RetStat.Set("SharedModules", SharedModules);
+
+  if (auto *Trampoline =
+          Info.Env().GetInstanceData<AddonData>()->Trampoline.get()) {
+    Napi::Object HostCalls = Napi::Object::New(Info.Env());
+    HostCalls.Set("Calls",
+                  Napi::Number::New(Info.Env(), Trampoline->getCalls()));
+    HostCalls.Set("Batches",
+                  Napi::Number::New(Info.Env(), Trampoline->getBatches()));
+    RetStat.Set("HostCalls", HostCalls);
+  }
+
   return RetStat;
 }
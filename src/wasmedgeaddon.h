@@ -1,18 +1,47 @@
 #ifndef WASMEDGEADDON_H
 #define WASMEDGEADDON_H
 
+#include "asyncrun.h"
 #include "bytecode.h"
 #include "cache.h"
+#include "compiler.h"
 #include "errors.h"
+#include "extensions.h"
+#include "filearg.h"
+#include "hostimports.h"
+#include "linking.h"
+#include "memfs.h"
+#include "memoize.h"
+#include "memstat.h"
+#include "modulestream.h"
+#include "msgpack.h"
 #include "options.h"
+#include "perfcounters.h"
+#include "profiler.h"
+#include "registry.h"
 #include "utils.h"
+#include "validation.h"
+#include "values.h"
+#include "wasminfo.h"
 
+#include <chrono>
+#include <limits>
+#include <map>
 #include <napi.h>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <wasmedge/wasmedge.h>
 
+/// Per napi_env state of the addon.
+struct AddonData {
+  Napi::FunctionReference Constructor;
+  /// Class of the streams accepted by the constructor instead of bytecode
+  Napi::FunctionReference StreamConstructor;
+  /// Created by the first VM with JS imports.
+  std::unique_ptr<WASMEDGE::NAPI::HostCallTrampoline> Trampoline;
+};
+
 class WasmEdgeAddon : public Napi::ObjectWrap<WasmEdgeAddon> {
 public:
   static Napi::Object Init(Napi::Env Env, Napi::Object Exports);
@@ -22,43 +51,132 @@ public:
       WasmEdge_ConfigureDelete(Configure);
       Configure = nullptr;
     }
+    if (Interp != nullptr) {
+      WasmEdge_InterpreterDelete(Interp);
+      Interp = nullptr;
+    }
     if (VM != nullptr) {
       WasmEdge_VMDelete(VM);
       VM = nullptr;
     }
+    RemoveMemFSOverlays();
+    if (ProfileHookAdded) {
+      napi_remove_env_cleanup_hook(Env(), FlushProfile, this);
+    }
   };
 
   enum class IntKind { Default, SInt32, UInt32, SInt64, UInt64 };
 
 private:
   using ErrorType = WASMEDGE::NAPI::ErrorType;
-  static Napi::FunctionReference Constructor;
   WasmEdge_ConfigureContext *Configure;
   WasmEdge_StoreContext *Store;
   WasmEdge_VMContext *VM;
+  /// Set while a trusted module is instantiated without validation. Calls
+  /// are then invoked through it instead of the VM.
+  WasmEdge_InterpreterContext *Interp = nullptr;
   WasmEdge_MemoryInstanceContext *MemInst;
   WasmEdge_StatisticsContext *Stat;
   WasmEdge_ImportObjectContext *WasiMod;
   WasmEdge_ImportObjectContext *ImageMod;
   WasmEdge_ImportObjectContext *TensorflowMod;
   WasmEdge_ImportObjectContext *TensorflowLiteMod;
+  /// Host modules of JS functions given in the `imports` option
+  std::vector<std::unique_ptr<WASMEDGE::NAPI::JSImportModule>> JSImports;
+  std::vector<WasmEdge_ImportObjectContext *> JSImportMods;
+  /// Modules given in the `modules` option, registered in this order
+  std::vector<WASMEDGE::NAPI::LinkedModule> LinkedModules;
   WASMEDGE::NAPI::Bytecode BC;
   WASMEDGE::NAPI::Options Options;
   WASMEDGE::NAPI::Cache Cache;
+  std::shared_ptr<const WASMEDGE::NAPI::SharedModule> Module;
+  WASMEDGE::NAPI::MemoryStatistics MemStat;
+  WASMEDGE::NAPI::Profiler Profiler;
+  /// Env cleanup hook which writes the remaining profile at exit
+  static void FlushProfile(void *Addon) {
+    static_cast<WasmEdgeAddon *>(Addon)->Profiler.flush(true);
+  }
+  bool ProfileHookAdded = false;
+  WASMEDGE::NAPI::PerfCounters PerfCounters;
+  /// Guest and host path of the writable memfs trees of the current call
+  std::vector<std::pair<std::string, std::string>> MemFSOverlays;
+  /// Files of the writable memfs trees after the last call
+  std::map<std::string, std::vector<uint8_t>> MemFSFiles;
+  /// Results of the exports in `PureFunctions`
+  WASMEDGE::NAPI::MemoCache Memo;
+  /// Scratch buffer of RunValue, keeps its capacity between calls
+  std::vector<uint8_t> EncodeBuffer;
   bool Inited;
+  /// An asynchronous call is using the VM.
+  bool Busy = false;
+  /// A synchronous call is using the VM. Set for the whole call, so JS
+  /// imports can not re-enter the instance.
+  bool InCall = false;
+  struct InCallScope {
+    explicit InCallScope(bool &Flag) : Flag(Flag) { Flag = true; }
+    ~InCallScope() { Flag = false; }
+    bool &Flag;
+  };
+  /// RunAsync calls waiting for the VM.
+  WASMEDGE::NAPI::AdmissionQueue<std::unique_ptr<WASMEDGE::NAPI::PendingCall>>
+      Queue;
+  /// JS timer for the earliest deadline in the queue, and when it fires.
+  Napi::Reference<Napi::Value> DeadlineTimer;
+  std::chrono::steady_clock::time_point TimerDeadline =
+      std::chrono::steady_clock::time_point::max();
 
   /// Setup related functions
-  void InitVM(const Napi::CallbackInfo &Info);
+  void InitVM(Napi::Env Env);
   void FiniVM();
-  void InitWasi(const Napi::CallbackInfo &Info, const std::string &FuncName);
-  void LoadWasm(const Napi::CallbackInfo &Info);
+  void InitWasi(Napi::Env Env, const std::string &FuncName,
+                bool AllowTrusted = true);
+  void LoadWasm(Napi::Env Env, bool AllowTrusted);
+  bool InstantiateTrusted(const WASMEDGE::NAPI::SharedModule &Shared);
+  const WasmEdge_ASTModuleContext *AcquireModule();
+  /// Register the host modules of the extensions and the JS functions
+  /// imported by `AST` or by the linked modules. Requires LoadLinkedModules.
+  bool RegisterHostModules(Napi::Env Env, const WasmEdge_ASTModuleContext *AST);
+  bool ParseImports(Napi::Env Env, const Napi::Value &Imports);
+  bool ParseModules(Napi::Env Env, const Napi::Value &Modules);
+  bool AdoptStream(Napi::Env Env, WASMEDGE::NAPI::ModuleStream &Stream);
+  /// Parse the modules of the `modules` option.
+  bool LoadLinkedModules(Napi::Env Env);
+  /// Register the modules of the `modules` option in the store of the VM.
+  bool RegisterLinkedModules(Napi::Env Env, bool AllowTrusted);
+  void RemoveMemFSOverlays();
   /// WasmBindgen related functions
   void PrepareResource(const Napi::CallbackInfo &Info,
                        std::vector<WasmEdge_Value> &Args, IntKind IntT);
+  void PrepareResource(Napi::Env Env, const std::string &FuncName,
+                       const std::vector<Napi::Value> &Values,
+                       std::vector<WasmEdge_Value> &Args, IntKind IntT);
   void PrepareResource(const Napi::CallbackInfo &Info,
                        std::vector<WasmEdge_Value> &Args);
+  /// Allocate guest memory with __wbindgen_malloc, copy `Data` into it and
+  /// append the pointer and length to `Args`.
+  bool CopyToGuest(Napi::Env Env, const uint8_t *Data, uint32_t Size,
+                   std::vector<WasmEdge_Value> &Args);
+  /// Read the range of a `{file, offset, length}` argument into guest memory
+  /// allocated with __wbindgen_malloc and append the pointer and length.
+  bool ReadToGuest(Napi::Env Env, const Napi::Object &File,
+                   std::vector<WasmEdge_Value> &Args);
+  /// Allocate `Size` bytes with __wbindgen_malloc. Throws on failure.
+  bool AllocateInGuest(Napi::Env Env, uint32_t Size, uint32_t &Addr);
   void ReleaseResource(const Napi::CallbackInfo &Info, const uint32_t Offset,
                        const uint32_t Size);
+  /// Invoke a function of the loaded module, without profiling
+  WasmEdge_Result Invoke(const WasmEdge_String FuncName,
+                         const WasmEdge_Value *Params, const uint32_t ParamLen,
+                         WasmEdge_Value *Rets, const uint32_t RetLen);
+  /// Execute an exported function of the loaded module
+  WasmEdge_Result Execute(const std::string &FuncName,
+                          const std::vector<WasmEdge_Value> &Args,
+                          WasmEdge_Value *Rets, const uint32_t RetLen);
+  /// Serve calls of the exports in `PureFunctions` with the same arguments
+  /// from the memoization cache. `Tag` tells the Run methods apart.
+  template <Napi::Value (WasmEdgeAddon::*Method)(const Napi::CallbackInfo &),
+            char Tag>
+  Napi::Value Memoized(const Napi::CallbackInfo &Info);
   /// Run functions
   void Run(const Napi::CallbackInfo &Info);
   Napi::Value RunStart(const Napi::CallbackInfo &Info);
@@ -68,16 +186,44 @@ private:
   Napi::Value RunUInt(const Napi::CallbackInfo &Info);
   Napi::Value RunInt64(const Napi::CallbackInfo &Info);
   Napi::Value RunUInt64(const Napi::CallbackInfo &Info);
+  Napi::Value RunFloatImpl(const Napi::CallbackInfo &Info,
+                           WasmEdge_ValType RetT);
+  Napi::Value RunFloat(const Napi::CallbackInfo &Info);
+  Napi::Value RunDouble(const Napi::CallbackInfo &Info);
+  Napi::Value RunMulti(const Napi::CallbackInfo &Info);
   Napi::Value RunString(const Napi::CallbackInfo &Info);
   Napi::Value RunUint8Array(const Napi::CallbackInfo &Info);
+  Napi::Value RunValue(const Napi::CallbackInfo &Info);
+  /// Chain functions returning Vec<u8> inside the guest
+  Napi::Value RunPipeline(const Napi::CallbackInfo &Info);
+  /// Read the pointer and length of a Vec<u8> result written to `RetAddr`.
+  bool ReadResultRegion(uint32_t RetAddr, uint32_t &Addr, uint32_t &Len);
+  /// Copy a result region into a new Uint8Array and free it in the guest.
+  Napi::Value CopyResultOut(const Napi::CallbackInfo &Info, uint32_t Addr,
+                            uint32_t Len);
+  Napi::Value RunAsync(const Napi::CallbackInfo &Info);
+  void StartAsync(Napi::Env Env,
+                  std::unique_ptr<WASMEDGE::NAPI::PendingCall> Call);
+  void DispatchNext(Napi::Env Env);
+  /// Reject the queued calls whose deadline passed or which were aborted.
+  void ExpireQueued(Napi::Env Env);
+  void AbortQueued(Napi::Env Env, const WASMEDGE::NAPI::PendingCall *Target);
+  /// (Re)arm DeadlineTimer for the earliest deadline in the queue.
+  void ArmDeadlineTimer(Napi::Env Env);
+  bool CheckIdle(const Napi::CallbackInfo &Info);
   /// Statistics
   Napi::Value GetStatistics(const Napi::CallbackInfo &Info);
+  /// Memfs
+  Napi::Value GetMemFSFiles(const Napi::CallbackInfo &Info);
   /// AoT functions
-  bool Compile();
-  bool CompileBytecodeTo(const std::string &Path);
-  void InitReactor(const Napi::CallbackInfo &Info);
+  bool Compile(WASMEDGE::NAPI::Bytecode &Code,
+               WASMEDGE::NAPI::Cache &CodeCache);
+  bool CompileBytecodeTo(WASMEDGE::NAPI::Bytecode &Code,
+                         const std::string &Path);
+  void InitReactor(Napi::Env Env);
   /// Error handling functions
   void ThrowNapiError(const Napi::CallbackInfo &Info, ErrorType Type);
+  void ThrowNapiError(Napi::Env Env, ErrorType Type);
 };
 
 #endif
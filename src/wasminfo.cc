@@ -0,0 +1,132 @@
+#include "wasminfo.h"
+
+namespace WASMEDGE {
+namespace NAPI {
+
+namespace {
+
+/// Minimal reader over the wasm binary format.
+class Reader {
+public:
+  Reader(const uint8_t *Begin, const uint8_t *End) : Cur(Begin), End(End) {}
+
+  bool readByte(uint8_t &Byte) {
+    if (Cur >= End) {
+      return false;
+    }
+    Byte = *Cur++;
+    return true;
+  }
+
+  bool readU32(uint32_t &Value) {
+    Value = 0;
+    for (uint32_t Shift = 0; Shift < 35; Shift += 7) {
+      uint8_t Byte;
+      if (!readByte(Byte)) {
+        return false;
+      }
+      Value |= static_cast<uint32_t>(Byte & 0x7F) << Shift;
+      if ((Byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool readName(std::string &Name) {
+    uint32_t Len;
+    if (!readU32(Len) || static_cast<size_t>(End - Cur) < Len) {
+      return false;
+    }
+    Name.assign(reinterpret_cast<const char *>(Cur), Len);
+    Cur += Len;
+    return true;
+  }
+
+  bool skip(uint32_t Len) {
+    if (static_cast<size_t>(End - Cur) < Len) {
+      return false;
+    }
+    Cur += Len;
+    return true;
+  }
+
+  const uint8_t *pos() const noexcept { return Cur; }
+  bool eof() const noexcept { return Cur >= End; }
+
+private:
+  const uint8_t *Cur;
+  const uint8_t *End;
+};
+
+/// Iterate the sections of a module. `Callback(Id, Payload)` returns false to
+/// stop the iteration.
+template <typename CallbackT>
+bool forEachSection(const std::vector<uint8_t> &Wasm, CallbackT &&Callback) {
+  /// Magic and version.
+  if (Wasm.size() < 8 || Wasm[0] != 0x00 || Wasm[1] != 0x61 ||
+      Wasm[2] != 0x73 || Wasm[3] != 0x6D) {
+    return false;
+  }
+  Reader R(Wasm.data() + 8, Wasm.data() + Wasm.size());
+  while (!R.eof()) {
+    uint8_t Id;
+    uint32_t Size;
+    if (!R.readByte(Id) || !R.readU32(Size)) {
+      return false;
+    }
+    const uint8_t *Payload = R.pos();
+    if (!R.skip(Size)) {
+      return false;
+    }
+    if (!Callback(Id, Reader(Payload, Payload + Size))) {
+      break;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+std::map<uint32_t, std::string>
+readFunctionNames(const std::vector<uint8_t> &Wasm) {
+  std::map<uint32_t, std::string> Names;
+  forEachSection(Wasm, [&](uint8_t Id, Reader R) {
+    std::string SectionName;
+    if (Id != 0 || !R.readName(SectionName) || SectionName != "name") {
+      return true;
+    }
+    while (!R.eof()) {
+      uint8_t SubId;
+      uint32_t SubSize;
+      if (!R.readByte(SubId) || !R.readU32(SubSize)) {
+        break;
+      }
+      /// Subsection 1 is the function name map.
+      if (SubId != 1) {
+        if (!R.skip(SubSize)) {
+          break;
+        }
+        continue;
+      }
+      uint32_t Count;
+      if (!R.readU32(Count)) {
+        break;
+      }
+      for (uint32_t I = 0; I < Count; I++) {
+        uint32_t Index;
+        std::string Name;
+        if (!R.readU32(Index) || !R.readName(Name)) {
+          break;
+        }
+        Names[Index] = std::move(Name);
+      }
+      break;
+    }
+    return false;
+  });
+  return Names;
+}
+
+} // namespace NAPI
+} // namespace WASMEDGE
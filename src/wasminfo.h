@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace WASMEDGE {
+namespace NAPI {
+
+/// Read the function names of the "name" custom section of a wasm module,
+/// indexed by function index. Returns an empty map if there is no name
+/// section or the module is malformed.
+std::map<uint32_t, std::string>
+readFunctionNames(const std::vector<uint8_t> &Wasm);
+
+} // namespace NAPI
+} // namespace WASMEDGE
@@ -0,0 +1,170 @@
+'use strict';
+
+const assert = require('assert');
+const crypto = require('crypto');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const wasmedge = require('..');
+
+// FNV-1a over the index and the artifacts, printed as a decimal uint64.
+function fnv1a(data) {
+  let hash = 14695981039346656037n;
+  for (const byte of Buffer.from(data)) {
+    hash = ((hash ^ BigInt(byte)) * 1099511628211n) & 0xffffffffffffffffn;
+  }
+  return hash.toString();
+}
+
+// The header lines (version, key, arch, features) of a bundle written by
+// this host, without its entries.
+function readHeader(bundle) {
+  const fd = fs.openSync(bundle, 'r');
+  const buffer = Buffer.alloc(1 << 20);
+  const size = fs.readSync(fd, buffer, 0, buffer.length, 0);
+  fs.closeSync(fd);
+  const lines = buffer.subarray(0, size).toString('latin1').split('\n');
+  assert.strictEqual(lines[0], 'WASMEDGE-AOT-BUNDLE 1');
+  const header = {};
+  for (const line of lines.slice(1)) {
+    const [kind, ...fields] = line.split(' ');
+    if (kind === 'end') {
+      break;
+    }
+    if (kind !== 'entry') {
+      header[kind] = fields.join(' ');
+    }
+  }
+  return header;
+}
+
+describe('cache.export and cache.import', function() {
+  let dir, header;
+  const installed = [];
+
+  before(async function() {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'wasmedge-bundle-'));
+    const exported = path.join(dir, 'exported.bundle');
+    const stats = await wasmedge.cache.export(exported);
+    assert.strictEqual(typeof stats.entries, 'number');
+    header = readHeader(exported);
+    assert.ok(header.version && header.key && header.arch);
+  });
+
+  after(function() {
+    fs.rmSync(dir, {recursive: true, force: true});
+    for (const file of installed) {
+      fs.rmSync(file, {force: true});
+    }
+  });
+
+  // Write a bundle from header fields and artifacts. `entries` are
+  // `{name, data}`, optionally with `size` or `checksum` overrides.
+  function writeBundle(name, fields, entries = [], options = {}) {
+    const lines = [
+      `version ${fields.version}`, `key ${fields.key}`,
+      `arch ${fields.arch}`, `features ${fields.features}`.trimEnd(),
+    ];
+    let offset = 0;
+    for (const entry of entries) {
+      const size = entry.size !== undefined ? entry.size : entry.data.length;
+      const checksum =
+          entry.checksum !== undefined ? entry.checksum : fnv1a(entry.data);
+      lines.push(`entry ${entry.name} ${offset} ${size} ${checksum}`);
+      offset += entry.data.length;
+    }
+    const index = lines.map((line) => line + '\n').join('');
+    const checksum =
+        options.checksum !== undefined ? options.checksum : fnv1a(index);
+    const end = options.unterminated ? '' : `end ${checksum}\n`;
+    const file = path.join(dir, name);
+    fs.writeFileSync(file, Buffer.concat([
+      Buffer.from(`WASMEDGE-AOT-BUNDLE 1\n${index}${end}`),
+      ...entries.map((entry) => Buffer.from(entry.data)),
+    ]));
+    return file;
+  }
+
+  function entryName() {
+    const name =
+        `wasmedge.tmp.${crypto.randomBytes(32).toString('hex')}.so`;
+    installed.push(path.join('/tmp', name));
+    return name;
+  }
+
+  it('reads back an empty bundle of this host', async function() {
+    const bundle = writeBundle('empty.bundle', header);
+    assert.deepStrictEqual(await wasmedge.cache.import(bundle),
+                           {installed: 0, existing: 0, rejected: 0, bytes: 0});
+  });
+
+  it('installs new entries once', async function() {
+    const data = crypto.randomBytes(3000);
+    const name = entryName();
+    const bundle = writeBundle('one.bundle', header, [{name, data}]);
+    assert.deepStrictEqual(
+        await wasmedge.cache.import(bundle),
+        {installed: 1, existing: 0, rejected: 0, bytes: 3000});
+    assert.ok(data.equals(fs.readFileSync(path.join('/tmp', name))));
+    assert.strictEqual(fs.statSync(path.join('/tmp', name)).mode & 0o777,
+                       0o644);
+    assert.deepStrictEqual(
+        await wasmedge.cache.import(bundle),
+        {installed: 0, existing: 1, rejected: 0, bytes: 0});
+  });
+
+  it('rejects entries with a bad checksum or size', async function() {
+    const bad = {name: entryName(), data: 'abc', checksum: '1'};
+    const short = {name: entryName(), data: 'def', size: 4096};
+    const bundle = writeBundle('bad.bundle', header, [bad, short]);
+    assert.deepStrictEqual(
+        await wasmedge.cache.import(bundle),
+        {installed: 0, existing: 0, rejected: 2, bytes: 0});
+    assert.ok(!fs.existsSync(path.join('/tmp', bad.name)));
+    assert.ok(!fs.existsSync(path.join('/tmp', short.name)));
+  });
+
+  it('rejects malformed bundles', async function() {
+    const invalid = /The file is not a valid AOT cache bundle/;
+    const notBundle = path.join(dir, 'not.bundle');
+    fs.writeFileSync(notBundle, '\0asm');
+    await assert.rejects(wasmedge.cache.import(notBundle), invalid);
+    await assert.rejects(
+        wasmedge.cache.import(path.join(dir, 'missing.bundle')), invalid);
+    await assert.rejects(
+        wasmedge.cache.import(writeBundle('unterminated.bundle', header, [],
+                                          {unterminated: true})),
+        invalid);
+    await assert.rejects(
+        wasmedge.cache.import(
+            writeBundle('checksum.bundle', header, [], {checksum: '0'})),
+        invalid);
+    for (const name of ['../../etc/passwd', 'wasmedge.tmp.abc.so',
+                        `wasmedge.tmp.${'0'.repeat(64)}.sh`]) {
+      await assert.rejects(
+          wasmedge.cache.import(
+              writeBundle('name.bundle', header, [{name, data: 'x'}])),
+          invalid);
+    }
+    assert.throws(() => wasmedge.cache.import(42),
+                  /Expected the path of a cache bundle/);
+  });
+
+  it('rejects bundles built for another host', async function() {
+    const cases = [
+      [{version: '0.0.0'}, /WasmEdge 0\.0\.0/],
+      [{key: 'other-scheme'}, /cache key scheme other-scheme/],
+      [{arch: 'pdp11'}, /architecture pdp11/],
+      [{features: `${header.features} avx_imaginary`.trim()},
+       /lacks the CPU feature avx_imaginary/],
+    ];
+    for (const [fields, message] of cases) {
+      const bundle =
+          writeBundle('foreign.bundle', {...header, ...fields},
+                      [{name: entryName(), data: 'x'}]);
+      await assert.rejects(wasmedge.cache.import(bundle),
+                           /The AOT cache bundle was built for another host/);
+      await assert.rejects(wasmedge.cache.import(bundle), message);
+    }
+  });
+});
@@ -0,0 +1,70 @@
+'use strict';
+
+const assert = require('assert');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const wasmedge = require('..');
+const {guest} = require('./fixtures/guest');
+
+describe('File range arguments', function() {
+  let dir, file, vm;
+  const content = Uint8Array.from({length: 256}, (_, i) => i);
+
+  before(function() {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'wasmedge-filearg-'));
+    file = path.join(dir, 'data.bin');
+    fs.writeFileSync(file, content);
+    vm = new wasmedge.VM(guest);
+  });
+
+  after(function() {
+    fs.rmSync(dir, {recursive: true, force: true});
+  });
+
+  const echo = (arg) => Array.from(vm.RunUint8Array('echo', arg));
+
+  it('reads the whole file by default', function() {
+    assert.deepStrictEqual(echo({file}), Array.from(content));
+  });
+
+  it('reads the given range', function() {
+    assert.deepStrictEqual(echo({file, offset: 10, length: 5}),
+                           [10, 11, 12, 13, 14]);
+    assert.deepStrictEqual(echo({file, offset: 250}),
+                           [250, 251, 252, 253, 254, 255]);
+    assert.deepStrictEqual(echo({file, offset: 1n, length: 2n}), [1, 2]);
+    assert.deepStrictEqual(echo({file, offset: 256}), []);
+    assert.deepStrictEqual(echo({file, offset: 0, length: 0}), []);
+  });
+
+  it('rejects ranges beyond the end of the file', function() {
+    assert.throws(() => echo({file, offset: 257}),
+                  /offset beyond the end of the file/);
+    assert.throws(() => echo({file, offset: 200, length: 57}),
+                  /range beyond the end of the file/);
+    assert.throws(() => echo({file, length: 2 ** 53}),
+                  /range beyond the end of the file/);
+  });
+
+  it('rejects malformed ranges', function() {
+    for (const range of [{file, offset: -1}, {file, offset: 1.5},
+                         {file, length: '4'}, {file, offset: 2 ** 54},
+                         {file, length: -1n}, {file: 42}]) {
+      assert.throws(() => echo(range), /Failed to read the file argument/);
+    }
+  });
+
+  it('rejects files which can not be read', function() {
+    assert.throws(() => echo({file: path.join(dir, 'missing')}),
+                  /Failed to read the file argument: .*missing/);
+    assert.throws(() => echo({file: dir}), /not a regular file/);
+  });
+
+  it('passes only the bytes of a Uint8Array view', function() {
+    const view = content.subarray(3, 6);
+    assert.deepStrictEqual(echo(view), [3, 4, 5]);
+    assert.deepStrictEqual(echo(Buffer.from(content.buffer, 100, 2)),
+                           [100, 101]);
+  });
+});
@@ -0,0 +1,60 @@
+'use strict';
+
+// A minimal guest using the wasm-bindgen calling convention of the addon,
+// assembled by hand so the tests do not need a Rust toolchain:
+//
+// (module
+//   (memory (export "memory") 1)
+//   (global $heap (mut i32) (i32.const 1024))
+//   ;; Bump allocator, growing the memory as needed. Every call gets a new
+//   ;; instance, so nothing is ever freed.
+//   (func (export "__wbindgen_malloc") (param $size i32) (result i32)
+//     (local $addr i32)
+//     (local.set $addr (global.get $heap))
+//     (global.set $heap (i32.and (i32.add (i32.add (global.get $heap)
+//                                                  (local.get $size))
+//                                         (i32.const 7))
+//                                (i32.const -8)))
+//     (block
+//       (br_if 0 (i32.le_u (global.get $heap)
+//                          (i32.shl (memory.size) (i32.const 16))))
+//       (drop (memory.grow
+//         (i32.shr_u (i32.add (i32.sub (global.get $heap)
+//                                      (i32.shl (memory.size) (i32.const 16)))
+//                             (i32.const 65535))
+//                    (i32.const 16)))))
+//     (local.get $addr))
+//   (func (export "__wbindgen_free") (param i32 i32))
+//   (func (export "add") (param i32 i32) (result i32)
+//     (i32.add (local.get 0) (local.get 1)))
+//   ;; fn echo(input: &[u8]) -> Vec<u8>, returns its argument.
+//   (func (export "echo") (param $ret i32) (param $ptr i32) (param $len i32)
+//     (i32.store (local.get $ret) (local.get $ptr))
+//     (i32.store offset=4 (local.get $ret) (local.get $len)))
+//   ;; Count down from $n, to keep the instance busy.
+//   (func (export "spin") (param $n i32) (result i32)
+//     (loop
+//       (br_if 0 (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (local.get $n)))
+module.exports.guest = Uint8Array.from([
+  0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x17, 0x04, 0x60,
+  0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x00, 0x60, 0x02, 0x7f,
+  0x7f, 0x01, 0x7f, 0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x00, 0x03, 0x06, 0x05,
+  0x00, 0x01, 0x02, 0x03, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x06, 0x07,
+  0x01, 0x7f, 0x01, 0x41, 0x80, 0x08, 0x0b, 0x07, 0x44, 0x06, 0x06, 0x6d,
+  0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02, 0x00, 0x11, 0x5f, 0x5f, 0x77, 0x62,
+  0x69, 0x6e, 0x64, 0x67, 0x65, 0x6e, 0x5f, 0x6d, 0x61, 0x6c, 0x6c, 0x6f,
+  0x63, 0x00, 0x00, 0x0f, 0x5f, 0x5f, 0x77, 0x62, 0x69, 0x6e, 0x64, 0x67,
+  0x65, 0x6e, 0x5f, 0x66, 0x72, 0x65, 0x65, 0x00, 0x01, 0x03, 0x61, 0x64,
+  0x64, 0x00, 0x02, 0x04, 0x65, 0x63, 0x68, 0x6f, 0x00, 0x03, 0x04, 0x73,
+  0x70, 0x69, 0x6e, 0x00, 0x04, 0x0a, 0x66, 0x05, 0x37, 0x01, 0x01, 0x7f,
+  0x23, 0x00, 0x21, 0x01, 0x23, 0x00, 0x20, 0x00, 0x6a, 0x41, 0x07, 0x6a,
+  0x41, 0x78, 0x71, 0x24, 0x00, 0x02, 0x40, 0x23, 0x00, 0x3f, 0x00, 0x41,
+  0x10, 0x74, 0x4d, 0x0d, 0x00, 0x23, 0x00, 0x3f, 0x00, 0x41, 0x10, 0x74,
+  0x6b, 0x41, 0xff, 0xff, 0x03, 0x6a, 0x41, 0x10, 0x76, 0x40, 0x00, 0x1a,
+  0x0b, 0x20, 0x01, 0x0b, 0x02, 0x00, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20,
+  0x01, 0x6a, 0x0b, 0x10, 0x00, 0x20, 0x00, 0x20, 0x01, 0x36, 0x02, 0x00,
+  0x20, 0x00, 0x20, 0x02, 0x36, 0x02, 0x04, 0x0b, 0x10, 0x00, 0x03, 0x40,
+  0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x20, 0x00,
+  0x0b,
+]);
@@ -0,0 +1,76 @@
+'use strict';
+
+const assert = require('assert');
+const wasmedge = require('..');
+const {guest} = require('./fixtures/guest');
+
+function memoStat(vm) {
+  return vm.GetStatistics().Memoize;
+}
+
+describe('PureFunctions', function() {
+  it('answers repeated calls from the cache', function() {
+    const vm = new wasmedge.VM(guest, {PureFunctions: ['add']});
+    assert.strictEqual(vm.RunInt('add', 1, 2), 3);
+    assert.strictEqual(vm.RunInt('add', 1, 2), 3);
+    assert.strictEqual(vm.RunInt('add', 2, 1), 3);
+    // The Run method is part of the key.
+    assert.strictEqual(vm.RunUInt('add', 1, 2), 3);
+    const {Hits, Misses, Entries, Evictions} = memoStat(vm);
+    assert.deepStrictEqual([Hits, Misses, Entries, Evictions], [1, 3, 3, 0]);
+  });
+
+  it('drops the least recently used result beyond MemoizeCapacity',
+     function() {
+       const vm = new wasmedge.VM(guest,
+                                  {PureFunctions: ['add'], MemoizeCapacity: 2});
+       vm.RunInt('add', 1, 1);
+       vm.RunInt('add', 2, 2);
+       vm.RunInt('add', 1, 1); // hit, now the most recently used
+       vm.RunInt('add', 3, 3); // evicts add(2, 2)
+       assert.strictEqual(memoStat(vm).Evictions, 1);
+       assert.strictEqual(memoStat(vm).Entries, 2);
+
+       const {Hits, Misses} = memoStat(vm);
+       vm.RunInt('add', 1, 1);
+       vm.RunInt('add', 3, 3);
+       assert.strictEqual(memoStat(vm).Hits, Hits + 2);
+       vm.RunInt('add', 2, 2);
+       assert.strictEqual(memoStat(vm).Misses, Misses + 1);
+     });
+
+  it('stays within MemoizeMaxBytes', function() {
+    const maxBytes = 4096;
+    const vm = new wasmedge.VM(
+        guest, {PureFunctions: ['echo'], MemoizeMaxBytes: maxBytes});
+    for (let i = 0; i < 10; i++) {
+      vm.RunUint8Array('echo', new Uint8Array(1000).fill(i));
+      assert.ok(memoStat(vm).Bytes <= maxBytes);
+    }
+    assert.ok(memoStat(vm).Entries < 10);
+    assert.ok(memoStat(vm).Evictions > 0);
+
+    // A result larger than the bound is not kept at all.
+    const {Entries, Bytes} = memoStat(vm);
+    vm.RunUint8Array('echo', new Uint8Array(maxBytes));
+    assert.strictEqual(memoStat(vm).Entries, Entries);
+    assert.strictEqual(memoStat(vm).Bytes, Bytes);
+  });
+
+  it('returns a new copy on every hit', function() {
+    const vm = new wasmedge.VM(guest, {PureFunctions: ['echo']});
+    const first = vm.RunUint8Array('echo', Uint8Array.of(1, 2, 3));
+    first[0] = 42;
+    const second = vm.RunUint8Array('echo', Uint8Array.of(1, 2, 3));
+    assert.strictEqual(memoStat(vm).Hits, 1);
+    assert.deepStrictEqual(Array.from(second), [1, 2, 3]);
+  });
+
+  it('does not memoize other exports', function() {
+    const vm = new wasmedge.VM(guest, {PureFunctions: ['echo']});
+    vm.RunInt('add', 1, 2);
+    vm.RunInt('add', 1, 2);
+    assert.strictEqual(memoStat(vm).Hits, 0);
+    assert.strictEqual(memoStat(vm).Entries, 0);
+  });
+});
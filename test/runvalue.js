@@ -0,0 +1,61 @@
+'use strict';
+
+const assert = require('assert');
+const wasmedge = require('..');
+const {guest} = require('./fixtures/guest');
+
+// `echo` hands the MessagePack encoding of its argument back unchanged, so
+// every value makes a round trip through the native encoder and decoder.
+describe('RunValue', function() {
+  let vm;
+  before(function() {
+    vm = new wasmedge.VM(guest);
+  });
+  const roundTrip = (value) => vm.RunValue('echo', value);
+
+  it('round-trips scalars', function() {
+    for (const value of [null, true, false, 0, 1, -1, 127, 128, -33, 65535,
+                         -2147483648, 4294967295, Number.MAX_SAFE_INTEGER,
+                         Number.MIN_SAFE_INTEGER, 1.5, -0.25, 1e300, '',
+                         'hello', 'héllo wörld ✓', 'x'.repeat(70000)]) {
+      assert.strictEqual(roundTrip(value), value);
+    }
+    assert.strictEqual(roundTrip(undefined), null);
+  });
+
+  it('decodes integers beyond the safe range as BigInt', function() {
+    assert.strictEqual(roundTrip(2n ** 60n), 2n ** 60n);
+    assert.strictEqual(roundTrip(-(2n ** 60n)), -(2n ** 60n));
+    assert.strictEqual(roundTrip(2n ** 64n - 1n), 2n ** 64n - 1n);
+    assert.strictEqual(roundTrip(42n), 42);
+  });
+
+  it('round-trips binaries, arrays and maps', function() {
+    const bin = roundTrip(Uint8Array.of(0, 1, 255));
+    assert.ok(bin instanceof Uint8Array);
+    assert.deepStrictEqual(Array.from(bin), [0, 1, 255]);
+    assert.deepStrictEqual(Array.from(roundTrip(Uint8Array.of(9).buffer)),
+                           [9]);
+
+    const value = {
+      name: 'Amy',
+      scores: [98, 87.5, null, [true, {}]],
+      nested: {empty: [], text: 'ok'},
+    };
+    assert.deepStrictEqual(roundTrip(value), value);
+    const wide = Array.from({length: 70000}, (_, i) => i);
+    assert.deepStrictEqual(roundTrip(wide), wide);
+  });
+
+  it('keeps __proto__ keys as own properties', function() {
+    const value = JSON.parse('{"__proto__": {"polluted": 1}, "a": 1}');
+    const result = roundTrip(value);
+    assert.deepStrictEqual(Object.keys(result), ['__proto__', 'a']);
+    assert.strictEqual(Object.getPrototypeOf(result), Object.prototype);
+    assert.strictEqual(result.polluted, undefined);
+    assert.strictEqual(({}).polluted, undefined);
+    assert.deepStrictEqual(
+        Object.getOwnPropertyDescriptor(result, '__proto__').value,
+        {polluted: 1});
+  });
+});
@@ -0,0 +1,94 @@
+'use strict';
+
+const assert = require('assert');
+const wasmedge = require('..');
+const {guest} = require('./fixtures/guest');
+
+// Keeps the instance busy until it is aborted.
+function block(vm) {
+  const controller = new AbortController();
+  const call = vm.RunAsync('spin', 0x7fffffff, {signal: controller.signal});
+  const done = call.catch((e) => assert.strictEqual(e.name, 'AbortError'));
+  return {done, release: () => controller.abort()};
+}
+
+describe('RunAsync scheduler', function() {
+  it('starts queued calls by priority, then by arrival', async function() {
+    const vm = new wasmedge.VM(guest);
+    const blocker = block(vm);
+    const order = [];
+    const calls = [
+      ['batch', 1], ['normal', 2], ['interactive', 3], ['normal', 4],
+      ['interactive', 5],
+    ].map(([priority, n]) =>
+      vm.RunAsync('add', n, 0, {priority}).then(([r]) => order.push(r)));
+    assert.strictEqual(vm.GetStatistics().Scheduler.QueueLength, 5);
+    blocker.release();
+    await Promise.all([blocker.done, ...calls]);
+    assert.deepStrictEqual(order, [3, 5, 2, 4, 1]);
+    assert.strictEqual(vm.GetStatistics().Scheduler.QueueLength, 0);
+  });
+
+  it('rejects calls beyond MaxQueueLength', async function() {
+    const vm = new wasmedge.VM(guest, {MaxQueueLength: 2});
+    const blocker = block(vm);
+    const queued = [vm.RunAsync('add', 1, 1), vm.RunAsync('add', 2, 2)];
+    await assert.rejects(vm.RunAsync('add', 3, 3), {code: 'ERR_QUEUE_FULL'});
+    await assert.rejects(vm.RunAsync('add', 4, 4, {priority: 'interactive'}),
+                         {code: 'ERR_QUEUE_FULL'});
+    blocker.release();
+    await blocker.done;
+    assert.deepStrictEqual(await Promise.all(queued), [[2], [4]]);
+    const stat = vm.GetStatistics().Scheduler;
+    assert.strictEqual(stat.MaxQueueLength, 2);
+    assert.strictEqual(stat.RejectedQueueFull, 2);
+  });
+
+  it('drops queued calls when their deadline passes', async function() {
+    const vm = new wasmedge.VM(guest);
+    const blocker = block(vm);
+    let released = false;
+    blocker.done.then(() => released = true);
+    const late = vm.RunAsync('add', 1, 1, {deadline: Date.now() + 20});
+    const patient = vm.RunAsync('add', 2, 2, {deadline: Date.now() + 60000});
+    // Rejected by the deadline timer while the instance is still busy.
+    await assert.rejects(late, {code: 'ERR_DEADLINE_EXCEEDED'});
+    assert.strictEqual(released, false);
+    blocker.release();
+    await blocker.done;
+    assert.deepStrictEqual(await patient, [4]);
+    assert.strictEqual(vm.GetStatistics().Scheduler.Expired, 1);
+  });
+
+  it('rejects a call whose deadline already passed', async function() {
+    const vm = new wasmedge.VM(guest);
+    await assert.rejects(vm.RunAsync('add', 1, 1, {deadline: Date.now() - 1}),
+                         {code: 'ERR_DEADLINE_EXCEEDED'});
+    assert.deepStrictEqual(await vm.RunAsync('add', 1, 1, {deadline: Infinity}),
+                           [2]);
+  });
+
+  it('removes an aborted call from the queue', async function() {
+    const vm = new wasmedge.VM(guest, {MaxQueueLength: 1});
+    const blocker = block(vm);
+    const controller = new AbortController();
+    const aborted = vm.RunAsync('add', 1, 1, {signal: controller.signal});
+    controller.abort();
+    await assert.rejects(aborted, {name: 'AbortError'});
+    // The slot is free again.
+    const next = vm.RunAsync('add', 2, 2);
+    blocker.release();
+    await blocker.done;
+    assert.deepStrictEqual(await next, [4]);
+  });
+
+  it('validates the call options', async function() {
+    const vm = new wasmedge.VM(guest);
+    for (const options of [{priority: 'urgent'}, {priority: 1},
+                           {deadline: 'soon'}, {deadline: NaN}]) {
+      await assert.rejects(vm.RunAsync('add', 1, 1, options),
+                           {code: 'ERR_INVALID_CALL_OPTIONS'});
+    }
+    await assert.rejects(vm.RunAsync(), /Unsupported argument type/);
+  });
+});
@@ -0,0 +1,402 @@
+#!/usr/bin/env node
+// Replay a trace of calls against a VM and report throughput, latency,
+// event-loop lag and RSS over time.
+//
+// Usage: node utils/loadgen/loadgen.js --wasm <file> [options]
+//   --trace FILE        Replay a JSON lines trace, looped for the duration.
+//                       Each line: {"at": ms, "method": "RunString",
+//                       "export": "name", "args": [...]}. An argument is a
+//                       literal or {"bytes": n} / {"string": n} for a
+//                       generated Uint8Array / string of n bytes.
+//   --export NAME       Synthetic trace: the function to call.
+//   --method NAME       Synthetic trace: the Run method. Default: Run.
+//   --args SPEC         Synthetic trace: comma separated arguments,
+//                       `bytes:N`, `string:N` or a number.
+//   --rate N            Synthetic trace: Poisson arrivals per second.
+//                       Default: 100.
+//   --write-trace FILE  Write the synthetic trace instead of replaying it.
+//   --mode MODE         inline: sync calls on the main thread.
+//                       workers: sync calls on worker threads, one VM each.
+//                       async: RunAsync on VMs of the main thread.
+//                       Default: workers.
+//   --concurrency N     Number of VMs. Default: 1.
+//   --duration S        Test duration in seconds. Default: 10.
+//   --interval S        Report interval in seconds. Default: 1.
+//   --options JSON      Options of the VM constructor.
+//   --max-outstanding N Calls which may wait before arrivals are dropped.
+//                       Default: 10000.
+//
+// Latency is measured from the scheduled arrival of a call to its
+// completion, so time spent waiting for a busy VM or a blocked event loop
+// is included. Every interval prints one JSON line; a summary follows.
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const {performance, monitorEventLoopDelay} = require('perf_hooks');
+const {Worker, isMainThread, parentPort, workerData} =
+    require('worker_threads');
+
+function loadAddon() {
+  return require(path.resolve(__dirname, '..', '..'));
+}
+
+const ArgCache = new Map();
+function materialize(args) {
+  return args.map((arg) => {
+    if (arg === null || typeof arg !== 'object') {
+      return arg;
+    }
+    const key = JSON.stringify(arg);
+    if (!ArgCache.has(key)) {
+      if (arg.bytes !== undefined) {
+        ArgCache.set(key, new Uint8Array(arg.bytes).fill(0x61));
+      } else if (arg.string !== undefined) {
+        ArgCache.set(key, 'a'.repeat(arg.string));
+      } else {
+        throw new Error(`Unknown argument ${key}`);
+      }
+    }
+    return ArgCache.get(key);
+  });
+}
+
+function createVM(config) {
+  const wasmedge = loadAddon();
+  return new wasmedge.VM(config.wasm, config.options);
+}
+
+// Sync calls on worker threads: each worker owns one VM and runs one call
+// at a time, the main thread only dispatches.
+if (!isMainThread) {
+  const vm = createVM(workerData);
+  parentPort.on('message', (call) => {
+    let error = null;
+    try {
+      vm[call.method](call.export, ...materialize(call.args));
+    } catch (e) {
+      error = String(e && e.message || e);
+    }
+    parentPort.postMessage({id: call.id, error});
+  });
+  return;
+}
+
+function parseArgs(argv) {
+  const opts = {
+    method: 'Run',
+    rate: 100,
+    mode: 'workers',
+    concurrency: 1,
+    duration: 10,
+    interval: 1,
+    options: {},
+    maxOutstanding: 10000,
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const next = () => {
+      if (i + 1 >= argv.length) {
+        throw new Error(`Missing value of ${argv[i]}`);
+      }
+      return argv[++i];
+    };
+    switch (argv[i]) {
+      case '--wasm': opts.wasm = next(); break;
+      case '--trace': opts.trace = next(); break;
+      case '--export': opts.export = next(); break;
+      case '--method': opts.method = next(); break;
+      case '--args': opts.args = next(); break;
+      case '--rate': opts.rate = Number(next()); break;
+      case '--write-trace': opts.writeTrace = next(); break;
+      case '--mode': opts.mode = next(); break;
+      case '--concurrency': opts.concurrency = Number(next()); break;
+      case '--duration': opts.duration = Number(next()); break;
+      case '--interval': opts.interval = Number(next()); break;
+      case '--options': opts.options = JSON.parse(next()); break;
+      case '--max-outstanding': opts.maxOutstanding = Number(next()); break;
+      default: throw new Error(`Unknown option ${argv[i]}`);
+    }
+  }
+  if (!opts.wasm && !opts.writeTrace) {
+    throw new Error('--wasm is required');
+  }
+  if (!opts.trace && !opts.export) {
+    throw new Error('Either --trace or --export is required');
+  }
+  return opts;
+}
+
+function parseArgSpec(spec) {
+  if (!spec) {
+    return [];
+  }
+  return spec.split(',').map((item) => {
+    const [kind, size] = item.split(':');
+    if (kind === 'bytes' || kind === 'string') {
+      return {[kind]: Number(size)};
+    }
+    return Number(item);
+  });
+}
+
+function readTrace(file) {
+  const calls = fs.readFileSync(file, 'utf8')
+                    .split('\n')
+                    .filter((line) => line.trim() !== '')
+                    .map((line) => JSON.parse(line));
+  for (const call of calls) {
+    if (!Number.isFinite(call.at) || call.at < 0) {
+      throw new Error(`Invalid arrival time in trace: ${JSON.stringify(call)}`);
+    }
+  }
+  calls.sort((a, b) => a.at - b.at);
+  return calls;
+}
+
+function syntheticTrace(opts) {
+  const args = parseArgSpec(opts.args);
+  const calls = [];
+  let at = 0;
+  while (at < opts.duration * 1000) {
+    calls.push({at, method: opts.method, export: opts.export, args});
+    at += -Math.log(1 - Math.random()) * 1000 / opts.rate;
+  }
+  return calls;
+}
+
+// Drivers run calls on VMs. submit() resolves when the call finished, or
+// rejects with its error. New execution modes are added here.
+const Drivers = {
+  inline(opts) {
+    if (opts.concurrency !== 1) {
+      throw new Error('inline mode runs a single VM');
+    }
+    const config = {wasm: opts.wasm, options: opts.options};
+    const vm = createVM(config);
+    return {
+      async start() {},
+      async submit(call) {
+        vm[call.method](call.export, ...materialize(call.args));
+      },
+      async stop() {},
+    };
+  },
+
+  workers(opts) {
+    const workers = [];
+    const idle = [];
+    const waiting = [];
+    const pending = new Map();
+    let nextId = 0;
+    const dispatch = () => {
+      while (idle.length > 0 && waiting.length > 0) {
+        const worker = idle.pop();
+        const {call, resolve, reject} = waiting.shift();
+        const id = nextId++;
+        pending.set(id, {worker, resolve, reject});
+        worker.postMessage({id, ...call});
+      }
+    };
+    return {
+      async start() {
+        for (let i = 0; i < opts.concurrency; i++) {
+          const worker = new Worker(__filename, {
+            workerData: {wasm: opts.wasm, options: opts.options},
+          });
+          worker.on('message', ({id, error}) => {
+            const entry = pending.get(id);
+            pending.delete(id);
+            idle.push(entry.worker);
+            if (error) {
+              entry.reject(new Error(error));
+            } else {
+              entry.resolve();
+            }
+            dispatch();
+          });
+          workers.push(worker);
+          idle.push(worker);
+        }
+      },
+      submit(call) {
+        return new Promise((resolve, reject) => {
+          waiting.push({call, resolve, reject});
+          dispatch();
+        });
+      },
+      async stop() {
+        await Promise.all(workers.map((worker) => worker.terminate()));
+      },
+    };
+  },
+
+  async(opts) {
+    const vms = [];
+    return {
+      async start() {
+        const config = {wasm: opts.wasm, options: opts.options};
+        for (let i = 0; i < opts.concurrency; i++) {
+          vms.push({vm: createVM(config), outstanding: 0});
+        }
+      },
+      async submit(call) {
+        // The least loaded VM; each VM queues its calls itself.
+        const target = vms.reduce((a, b) =>
+                                      b.outstanding < a.outstanding ? b : a);
+        target.outstanding++;
+        try {
+          await target.vm.RunAsync(call.export, ...materialize(call.args));
+        } finally {
+          target.outstanding--;
+        }
+      },
+      async stop() {},
+    };
+  },
+};
+
+function percentile(sorted, p) {
+  if (sorted.length === 0) {
+    return null;
+  }
+  const index = Math.min(sorted.length - 1, Math.ceil(p * sorted.length) - 1);
+  return Number(sorted[Math.max(0, index)].toFixed(3));
+}
+
+function summarize(latencies) {
+  const sorted = Float64Array.from(latencies).sort();
+  return {
+    p50: percentile(sorted, 0.5),
+    p99: percentile(sorted, 0.99),
+    p999: percentile(sorted, 0.999),
+    max: percentile(sorted, 1),
+  };
+}
+
+async function main() {
+  const opts = parseArgs(process.argv.slice(2));
+  const trace = opts.trace ? readTrace(opts.trace) : syntheticTrace(opts);
+  if (opts.writeTrace) {
+    fs.writeFileSync(opts.writeTrace,
+                     trace.map((call) => JSON.stringify(call)).join('\n') +
+                         '\n');
+    return;
+  }
+  if (trace.length === 0) {
+    throw new Error('The trace is empty');
+  }
+  if (!Drivers[opts.mode]) {
+    throw new Error(`Unknown mode ${opts.mode}`);
+  }
+
+  const driver = Drivers[opts.mode](opts);
+  await driver.start();
+
+  // A looped trace continues one mean inter-arrival time after its end. A
+  // trace whose calls all arrive at 0 would give a period of 0 and never
+  // advance, so it is replayed at most once per millisecond.
+  const last = trace[trace.length - 1].at;
+  const period = Math.max(
+      1, last + (trace.length > 1 ? last / (trace.length - 1) : 1));
+  const lag = monitorEventLoopDelay({resolution: 10});
+  const totalLag = monitorEventLoopDelay({resolution: 10});
+  lag.enable();
+  totalLag.enable();
+
+  const total = {latencies: [], completed: 0, errors: 0, dropped: 0};
+  let window = {latencies: [], completed: 0, errors: 0, dropped: 0};
+  let outstanding = 0;
+  const start = performance.now();
+  const end = start + opts.duration * 1000;
+  let index = 0;
+  let round = 0;
+
+  const finish = (at, failed) => {
+    const latency = performance.now() - at;
+    outstanding--;
+    for (const stats of [total, window]) {
+      stats.completed++;
+      stats.latencies.push(latency);
+      if (failed) {
+        stats.errors++;
+      }
+    }
+  };
+
+  const report = (final) => {
+    const now = performance.now();
+    const stats = final ? total : window;
+    const seconds = final ? (now - start) / 1000 : opts.interval;
+    const delay = final ? totalLag : lag;
+    const line = {
+      t: Number(((now - start) / 1000).toFixed(3)),
+      completed: stats.completed,
+      errors: stats.errors,
+      dropped: stats.dropped,
+      throughput: Number((stats.completed / seconds).toFixed(1)),
+      latencyMs: summarize(stats.latencies),
+      eventLoopLagMs: {
+        p99: Number((delay.percentile(99) / 1e6).toFixed(3)),
+        max: Number((delay.max / 1e6).toFixed(3)),
+      },
+      rssMB: Number((process.memoryUsage().rss / 1048576).toFixed(1)),
+      outstanding,
+    };
+    if (final) {
+      line.summary = true;
+      line.mode = opts.mode;
+      line.concurrency = opts.concurrency;
+    } else {
+      lag.reset();
+      window = {latencies: [], completed: 0, errors: 0, dropped: 0};
+    }
+    console.log(JSON.stringify(line));
+  };
+  const reporter = setInterval(() => report(false), opts.interval * 1000);
+
+  await new Promise((resolve) => {
+    const fire = () => {
+      const now = performance.now();
+      while (true) {
+        const call = trace[index];
+        const at = start + round * period + call.at;
+        if (at >= end) {
+          resolve();
+          return;
+        }
+        if (at > now) {
+          setTimeout(fire, at - now);
+          return;
+        }
+        if (outstanding >= opts.maxOutstanding) {
+          total.dropped++;
+          window.dropped++;
+        } else {
+          outstanding++;
+          driver.submit(call).then(() => finish(at, false),
+                                   () => finish(at, true));
+        }
+        if (++index === trace.length) {
+          index = 0;
+          round++;
+        }
+      }
+    };
+    fire();
+  });
+
+  // Let the calls in flight complete, they count towards the summary.
+  while (outstanding > 0) {
+    await new Promise((resolve) => setTimeout(resolve, 10));
+  }
+  clearInterval(reporter);
+  report(true);
+  lag.disable();
+  totalLag.disable();
+  await driver.stop();
+}
+
+main().catch((e) => {
+  console.error(e.message);
+  process.exit(1);
+});
@@ -0,0 +1,303 @@
+// Populate the AOT cache used by the addon ahead of time.
+//
+// Usage: wasmedge-precompile [options] <path>...
+//   <path> is a wasm file, a directory which is searched recursively for
+//   `.wasm` files, or a manifest file listing one wasm file path per line.
+//   --verify  Check existing cache entries and recompile broken ones.
+//   --warm    Read the compiled artifacts into the page cache.
+//   --jobs N  Number of compiler threads. Default: the number of CPUs.
+// The compiler settings must match the runtime options of the VM, otherwise
+// the runtime looks up a different cache entry:
+//   --opt-level O0|O1|O2|O3|Os|Oz  (CompilerOptimizationLevel)
+//   --target native|generic        (CompilerTargetCPU)
+//   --format native|wasm           (CompilerOutputFormat)
+//   --interruptible                (CompilerInterruptible)
+//   --measure                      (EnableMeasurement)
+#include "bytecode.h"
+#include "cache.h"
+#include "compiler.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Config {
+  bool Verify = false;
+  bool Warm = false;
+  uint32_t Jobs = std::max(1U, std::thread::hardware_concurrency());
+  WASMEDGE::NAPI::CompilerOptions CompilerOpts;
+  std::vector<std::string> Inputs;
+};
+
+bool endsWith(const std::string &S, const std::string &Suffix) {
+  return S.length() >= Suffix.length() &&
+         S.compare(S.length() - Suffix.length(), std::string::npos, Suffix) ==
+             0;
+}
+
+std::vector<uint8_t> readFile(const std::string &Path) {
+  std::ifstream File(Path.c_str(), std::ios::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(File)),
+                              std::istreambuf_iterator<char>());
+}
+
+bool collectInputs(const std::string &Path, std::vector<std::string> &Files,
+                   std::string &Error) {
+  std::error_code EC;
+  const std::filesystem::file_status Status =
+      std::filesystem::status(Path, EC);
+  if (EC) {
+    /// A mistyped path must not end up as an empty manifest.
+    Error = Path + ": " + EC.message();
+    return false;
+  }
+  if (std::filesystem::is_directory(Status)) {
+    for (std::filesystem::recursive_directory_iterator It(Path, EC), End;
+         !EC && It != End; It.increment(EC)) {
+      std::error_code TypeEC;
+      if (It->is_regular_file(TypeEC) && It->path().extension() == ".wasm") {
+        Files.push_back(It->path().string());
+      }
+    }
+    if (EC) {
+      Error = Path + ": " + EC.message();
+      return false;
+    }
+  } else if (endsWith(Path, ".wasm")) {
+    Files.push_back(Path);
+  } else {
+    /// Manifest: one wasm path per line, `#` starts a comment.
+    std::ifstream Manifest(Path.c_str());
+    if (!Manifest) {
+      Error = Path + ": cannot read the manifest";
+      return false;
+    }
+    std::string Line;
+    while (std::getline(Manifest, Line)) {
+      Line.erase(0, Line.find_first_not_of(" \t"));
+      Line.erase(Line.find_last_not_of(" \t\r") + 1);
+      if (!Line.empty() && Line[0] != '#' &&
+          !collectInputs(Line, Files, Error)) {
+        Error = Path + ": " + Error;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// A cache entry is usable if it is a native shared library, or a universal
+/// wasm file when the wasm output format is used, and the loader accepts it.
+bool verifyEntry(const WasmEdge_ConfigureContext *Configure,
+                 const std::string &Path,
+                 const WASMEDGE::NAPI::CompilerOptions &Opts) {
+  std::vector<uint8_t> Data = readFile(Path);
+  if (Data.size() < 4) {
+    return false;
+  }
+  WASMEDGE::NAPI::Bytecode BC;
+  BC.setData(Data);
+  const bool WasmFormat =
+      Opts.OutputFormat == WasmEdge_CompilerOutputFormat_Wasm;
+  if (WasmFormat ? !BC.isWasm() : !BC.isCompiled()) {
+    return false;
+  }
+  /// The magic bytes say nothing about truncated or stale artifacts, load
+  /// the entry like the runtime does.
+  WasmEdge_LoaderContext *Loader = WasmEdge_LoaderCreate(Configure);
+  WasmEdge_ASTModuleContext *AST = nullptr;
+  WasmEdge_Result Res =
+      WasmEdge_LoaderParseFromFile(Loader, &AST, Path.c_str());
+  WasmEdge_ASTModuleDelete(AST);
+  WasmEdge_LoaderDelete(Loader);
+  return WasmEdge_ResultOK(Res);
+}
+
+/// Read the whole file once so that the first load is served from memory.
+bool warmEntry(const std::string &Path) {
+  int FD = open(Path.c_str(), O_RDONLY);
+  if (FD < 0) {
+    return false;
+  }
+  posix_fadvise(FD, 0, 0, POSIX_FADV_WILLNEED);
+  std::vector<char> Buffer(1 << 20);
+  while (read(FD, Buffer.data(), Buffer.size()) > 0) {
+  }
+  close(FD);
+  return true;
+}
+
+bool processFile(const Config &Conf, const WasmEdge_ConfigureContext *Configure,
+                 const std::string &Input, std::string &Message) {
+  std::vector<uint8_t> Data = readFile(Input);
+  if (Data.size() < 4) {
+    Message = "not a wasm file";
+    return false;
+  }
+  WASMEDGE::NAPI::Bytecode BC;
+  BC.setData(Data);
+  if (!BC.isWasm()) {
+    Message = "not a wasm file";
+    return false;
+  }
+
+  WASMEDGE::NAPI::Cache Cache;
+  Cache.init(Data, Conf.CompilerOpts);
+  const std::string &CachePath = Cache.getPath();
+
+  const bool Cached = Cache.isCached();
+  WASMEDGE::NAPI::CacheFillStatus Status =
+      WASMEDGE::NAPI::CacheFillStatus::Cached;
+  WASMEDGE::NAPI::CompileResult Result = {false, 0, "", 0.0, 0};
+  if (!Cached || Conf.Verify) {
+    /// Shares the lock of the addon, so a VM starting meanwhile waits for
+    /// this compilation instead of repeating it, and a broken entry is only
+    /// replaced while no one else compiles it.
+    std::function<bool(const std::string &)> Accept;
+    if (Conf.Verify) {
+      Accept = [&](const std::string &Path) {
+        return verifyEntry(Configure, Path, Conf.CompilerOpts);
+      };
+    }
+    Status = WASMEDGE::NAPI::compileToCache(Configure, Input, CachePath,
+                                            true, Result, Accept);
+    if (Cached && Status == WASMEDGE::NAPI::CacheFillStatus::Compiled) {
+      Message = "recompiled broken entry, ";
+    }
+  }
+  if (Status == WASMEDGE::NAPI::CacheFillStatus::Failed) {
+    Message += "compile failed: " + Result.ErrorMessage;
+    return false;
+  }
+  if (Status == WASMEDGE::NAPI::CacheFillStatus::Compiled) {
+    Message += "compiled in " + std::to_string(Result.CompileTime) + " ms, " +
+               std::to_string(Result.OutputSize) + " bytes";
+  } else {
+    Message += "cached";
+  }
+
+  if (Conf.Warm && !warmEntry(CachePath)) {
+    Message += ", warm-up failed";
+    return false;
+  }
+  Message += " -> " + CachePath;
+  return true;
+}
+
+void printUsage(const char *Program) {
+  std::cerr << "Usage: " << Program
+            << " [--verify] [--warm] [--jobs N] [--opt-level LEVEL]"
+               " [--target native|generic] [--format native|wasm]"
+               " [--interruptible] [--measure] <wasm|dir|manifest>...\n";
+}
+
+bool parseJobs(const char *Str, uint32_t &Jobs) {
+  char *End = nullptr;
+  errno = 0;
+  long Value = std::strtol(Str, &End, 10);
+  if (End == Str || *End != '\0' || errno == ERANGE || Value < 1 ||
+      Value > INT_MAX) {
+    return false;
+  }
+  Jobs = static_cast<uint32_t>(Value);
+  return true;
+}
+
+} // namespace
+
+int main(int Argc, char **Argv) {
+  Config Conf;
+  for (int I = 1; I < Argc; I++) {
+    std::string Arg = Argv[I];
+    if (Arg == "--verify") {
+      Conf.Verify = true;
+    } else if (Arg == "--warm") {
+      Conf.Warm = true;
+    } else if (Arg == "--jobs" && I + 1 < Argc) {
+      if (!parseJobs(Argv[++I], Conf.Jobs)) {
+        std::cerr << "Invalid job count: " << Argv[I] << "\n";
+        printUsage(Argv[0]);
+        return 1;
+      }
+    } else if (Arg == "--opt-level" && I + 1 < Argc) {
+      if (!WASMEDGE::NAPI::parseOptimizationLevel(
+              Argv[++I], Conf.CompilerOpts.OptLevel)) {
+        std::cerr << "Unknown optimization level: " << Argv[I] << "\n";
+        return 1;
+      }
+    } else if (Arg == "--target" && I + 1 < Argc) {
+      if (!WASMEDGE::NAPI::parseTargetCPU(Argv[++I],
+                                          Conf.CompilerOpts.GenericBinary)) {
+        std::cerr << "Unknown target: " << Argv[I] << "\n";
+        return 1;
+      }
+    } else if (Arg == "--format" && I + 1 < Argc) {
+      if (!WASMEDGE::NAPI::parseOutputFormat(Argv[++I],
+                                             Conf.CompilerOpts.OutputFormat)) {
+        std::cerr << "Unknown output format: " << Argv[I] << "\n";
+        return 1;
+      }
+    } else if (Arg == "--interruptible") {
+      Conf.CompilerOpts.Interruptible = true;
+    } else if (Arg == "--measure") {
+      Conf.CompilerOpts.Measure = true;
+    } else {
+      Conf.Inputs.push_back(Arg);
+    }
+  }
+  if (Conf.Inputs.empty()) {
+    printUsage(Argv[0]);
+    return 1;
+  }
+
+  std::vector<std::string> Files;
+  for (const auto &Input : Conf.Inputs) {
+    std::string Error;
+    if (!collectInputs(Input, Files, Error)) {
+      std::cerr << Error << "\n";
+      return 1;
+    }
+  }
+
+  std::atomic<size_t> Next(0);
+  std::atomic<bool> Failed(false);
+  std::mutex OutputMutex;
+  auto Worker = [&]() {
+    WasmEdge_ConfigureContext *Configure =
+        WASMEDGE::NAPI::createConfigure(Conf.CompilerOpts);
+    for (size_t I = Next++; I < Files.size(); I = Next++) {
+      std::string Message;
+      bool Ok = processFile(Conf, Configure, Files[I], Message);
+      if (!Ok) {
+        Failed = true;
+      }
+      std::lock_guard<std::mutex> Lock(OutputMutex);
+      (Ok ? std::cout : std::cerr) << Files[I] << ": " << Message << "\n";
+    }
+    WasmEdge_ConfigureDelete(Configure);
+  };
+
+  std::vector<std::thread> Threads;
+  uint32_t ThreadCount = std::min(Conf.Jobs, static_cast<uint32_t>(Files.size()));
+  for (uint32_t I = 0; I < ThreadCount; I++) {
+    Threads.emplace_back(Worker);
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  return Failed ? 1 : 0;
+}